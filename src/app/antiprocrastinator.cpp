@@ -1,5 +1,18 @@
 #include "../headers/antiprocrastinator.h"
 #include "../headers/quotesdialog.h"
+#include "../headers/statsdialog.h"
+#include "../headers/timerengine.h"
+#include "../headers/persistenceworker.h"
+#include "../headers/settingsstore.h"
+#include "../headers/envconfig.h"
+#include "../headers/envconfigwatcher.h"
+#include "../headers/filechangewatcher.h"
+#include "../headers/theme.h"
+#include "../headers/quotebanner.h"
+#include "../headers/countdowndisplay.h"
+#include "../headers/trace.h"
+#include "../headers/sessionjournal.h"
+#include "../headers/connectionpool.h"
 #include <QFile>
 #include <QTextStream>
 #include <QDir>
@@ -11,36 +24,131 @@
 #include <QApplication>
 #include <QStringConverter>
 #include <QMenuBar>
-#include <QRegularExpression>
-#include <QSqlError>
-#include <QSqlRecord>
 #include <QStandardPaths>
 #include <QTimer>
+#include <QFutureWatcher>
+#include <QElapsedTimer>
+#include <QSignalBlocker>
+#include <QSystemTrayIcon>
+#include <QMenu>
+#include <QActionGroup>
+#include <QInputDialog>
+#include <QPainter>
+#include <QTime>
+#include <QDateTime>
+#include <QtConcurrent/QtConcurrentRun>
 #include <QDebug>
 
+namespace {
+
+// Свёрнутое окно просыпается раз в минуту: только чтобы журнал получал контрольные точки
+constexpr qint64 kHiddenWakeMs = 60 * 1000;
+
+// Значок трея рисуется кодом: ресурсов с иконками у приложения нет
+QIcon makeTrayIcon()
+{
+    QPixmap pixmap(32, 32);
+    pixmap.fill(Qt::transparent);
+    QPainter painter(&pixmap);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(QColor("#e74c3c"));
+    painter.drawEllipse(QRectF(3, 6, 26, 24));
+    painter.setBrush(QColor("#27ae60"));
+    painter.drawEllipse(QRectF(12, 2, 8, 7));
+    return QIcon(pixmap);
+}
+
+// Чтение бд профиля в фоновом потоке. Соединение берётся из пула и остаётся
+// за потоком пула: следующее переключение профиля или сводка на этом потоке
+// его переиспользуют, а при завершении потока пул его закроет. Схему пул
+// создаёт при первом открытии профиля, поэтому новый профиль заводится здесь же.
+// Здесь же открывается соединение потока окна reader: поток интерфейса
+// получает его готовым и сам не ждёт ни открытия файла, ни busy timeout
+StartupSnapshot readStartupSnapshot(ConnectionPool *pool, const QString &profile,
+                                    const QString &defaultTheme, int defaultDuration, QThread *reader)
+{
+    StartupSnapshot snapshot;
+    snapshot.profile = profile;
+    ProgressRepository *repository = pool->acquire(profile, nullptr, &snapshot.error);
+    if (!repository) return snapshot;
+
+    // Вставляем начальные значения, только если записей ещё нет (INSERT OR IGNORE)
+    repository->seedSettings(defaultTheme, defaultDuration);
+
+    snapshot.sessionsCompleted = repository->sessionCount();
+    snapshot.unlockedIds = repository->unlockedQuoteIds();
+    snapshot.unlocksMigrated = repository->unlocksMigrated();
+    snapshot.theme = repository->getSetting("theme", QString(), &snapshot.themeFound);
+    snapshot.duration = repository->getSetting("duration", QString(), &snapshot.durationFound);
+    snapshot.journalCommittedKey = repository->getCounter("journal_committed");
+    snapshot.repository = pool->acquireFor(profile, reader, &snapshot.error);
+    snapshot.ok = snapshot.repository != nullptr;
+    return snapshot;
+}
+
+} // namespace
+
 Antiprocrastinator::Antiprocrastinator(QWidget *parent)
     : QMainWindow(parent)
-    , m_timer(new QTimer(this))
+    , m_engine(new TimerEngine(this))
 {
-    // Загружаем настройки из .env-файла
-    loadEnvironmentConfig();
-
-    // Инициализируем бд для хранения сессий и настроек
-    if (!initDatabase()) {
-        QMessageBox::critical(this, "Ошибка базы данных",
-                              "Не удалось инициализировать базу данных прогресса.\n"
-                              "Приложение будет работать в режиме только для чтения.");
+    // Запуск разбит на этапы. Синхронно выполняется только то, что нужно для
+    // первого кадра: чтение .env и построение интерфейса с заглушками. Бд и
+    // цитаты загружаются параллельно в пуле потоков, а их результаты
+    // применяются в главном потоке по мере готовности
+    {
+        StartupTrace::Scope stage(m_trace, "чтение .env");
+        loadEnvironmentConfig();
     }
 
-    loadQuotes();      // Читаем цитаты из файла
-    setupUI();         // Собираем виджеты главного окна
-    setupMenuBar();    // Добавляем меню
-    loadProgress();    // Восстанавливаем прогресс из бд
-    applyTheme(m_defaultTheme);
+    auto *databaseWatcher = new QFutureWatcher<StartupSnapshot>(this);
+    connect(databaseWatcher, &QFutureWatcher<StartupSnapshot>::finished, this, [this, databaseWatcher]() {
+        {
+            StartupTrace::Scope stage(m_trace, "применение бд");
+            applyDatabase(databaseWatcher->result());
+        }
+        finishStartupStage();
+    });
+    m_databaseFuture = QtConcurrent::run(m_pool->readers(), [this, pool = m_pool, profile = m_profile,
+                                                             theme = m_defaultTheme, duration = m_defaultDuration,
+                                                             reader = thread()]() {
+        StartupTrace::Scope stage(m_trace, "открытие бд");
+        return readStartupSnapshot(pool, profile, theme, duration, reader);
+    });
+    databaseWatcher->setFuture(m_databaseFuture);
+
+    // Пока цитаты загружаются, главный поток не обращается к m_quotes.
+    // После загрузки правки файла цитат применяются без перезапуска
+    m_quotesFileWatcher = new FileChangeWatcher(this);
+    connect(m_quotesFileWatcher, &FileChangeWatcher::changed, this, &Antiprocrastinator::reloadQuotes);
+    auto *quotesWatcher = new QFutureWatcher<void>(this);
+    connect(quotesWatcher, &QFutureWatcher<void>::finished, this, [this]() {
+        m_quotesReady = true;
+        m_quotesFileWatcher->setFilePath(m_quotesTextPath);
+        finishStartupStage();
+    });
+    m_quotesFuture = QtConcurrent::run([this]() {
+        {
+            StartupTrace::Scope stage(m_trace, "загрузка цитат");
+            loadQuotes();
+        }
+        StartupTrace::Scope stage(m_trace, "индекс поиска");
+        m_quoteIndex.build(m_quotes);
+    });
+    quotesWatcher->setFuture(m_quotesFuture);
+
+    {
+        StartupTrace::Scope stage(m_trace, "построение интерфейса");
+        setupUI();         // Собираем виджеты главного окна
+        setupMenuBar();    // Добавляем меню
+        setupTray();
+        applyTheme(m_defaultTheme);
+    }
 
-    // Таймер срабатывает каждую секунду и обновляет отсчёт
-    m_timer->setInterval(1000);
-    connect(m_timer, &QTimer::timeout, this, &Antiprocrastinator::updateDisplay);
+    // Движок сам заводится на границу каждой секунды и сообщает о завершении
+    connect(m_engine, &TimerEngine::ticked, this, &Antiprocrastinator::updateDisplay);
+    connect(m_engine, &TimerEngine::finished, this, &Antiprocrastinator::timerFinished);
     connect(m_startButton, &QPushButton::clicked, this, &Antiprocrastinator::startTimer);
     connect(m_pauseButton, &QPushButton::clicked, this, &Antiprocrastinator::pauseTimer);
     connect(m_resetButton, &QPushButton::clicked, this, &Antiprocrastinator::resetTimer);
@@ -49,140 +157,247 @@ Antiprocrastinator::Antiprocrastinator(QWidget *parent)
     connect(m_durationSpinBox, QOverload<int>::of(&QSpinBox::valueChanged),
             this, &Antiprocrastinator::changeDuration);
 
+    m_pomodoroMinutes = m_defaultDuration;
     resetTimer();
+    setStartupControlsEnabled(false);
+
+    // Первый проход цикла событий наступает уже после показа окна
+    QTimer::singleShot(0, this, [this]() { m_trace.mark("окно показано"); });
 }
 
 Antiprocrastinator::~Antiprocrastinator()
 {
-    // Сохраняем текущие настройки перед выходом и закрываем соединение с бд
+    // Фоновые этапы запуска пишут в члены окна, поэтому дожидаемся их
+    m_quotesFuture.waitForFinished();
+    m_databaseFuture.waitForFinished();
+    m_profileFuture.waitForFinished();
+    m_summaryFuture.waitForFinished();
+
+    // Сохраняем текущие настройки перед выходом. Удаление потока записи
+    // дожидается, пока вся очередь команд окажется в бд
     saveProgress();
-    if (m_db.isOpen()) {
-        m_db.close();
+    delete m_settings;
+    m_settings = nullptr;
+    delete m_writer;
+    m_writer = nullptr;
+
+    // Пул дождётся своих потоков чтения, и каждый закроет свои соединения сам;
+    // отсюда закрываются только соединения главного потока
+    m_repository = nullptr;
+    delete m_pool;
+    m_pool = nullptr;
+
+    // Незавершённая сессия остаётся в журнале и восстановится при следующем запуске
+    for (SessionJournal *journal : std::as_const(m_journals)) {
+        journal->sync();
     }
-    QSqlDatabase::removeDatabase("progress_db");
+    qInfo().noquote() << wakeupSummary();
+
+    // Последними в трассировку попадают сохранение настроек и дописывание очереди
+    Trace::finish();
 }
 
 void Antiprocrastinator::loadEnvironmentConfig()
 {
-    // Ищем .env-файл рядом с исполняемым файлом или в текущей директории
-    QStringList searchPaths = {
-        QApplication::applicationDirPath(),
-        QApplication::applicationDirPath() + "/..",
-        QDir::currentPath()
-    };
+    // Разбор .env вынесен в loadEnvConfig, чтобы им пользовались и консольные команды
+    const EnvConfig config = loadEnvConfig();
+    if (!config.tracePath.isEmpty()) {
+        Trace::start(config.tracePath, config.traceBufferEvents);
+    }
+    m_quotesFilePath = config.quotesFilePath;
+    m_defaultTheme = config.defaultTheme;
+    m_defaultDuration = config.defaultDuration;
+    m_dbPath = config.dbPath;
+    m_profile = config.profile;
+    if (!ConnectionPool::isValidProfileName(m_profile)) {
+        qWarning() << "Недопустимое имя профиля в .env:" << m_profile << ", используется" << ConnectionPool::kDefaultProfile;
+        m_profile = ConnectionPool::kDefaultProfile;
+    }
+    m_pool = new ConnectionPool(m_dbPath);
 
-    QString envFile;
-    for (const QString &path : searchPaths) {
-        QString candidate = path + "/.env";
-        if (QFile::exists(candidate)) {
-            envFile = candidate;
-            break;
+    // Изменения .env подхватываются без перезапуска
+    m_configWatcher = new EnvConfigWatcher(config, this);
+    connect(m_configWatcher, &EnvConfigWatcher::reloaded, this, &Antiprocrastinator::onConfigReloaded);
+}
+
+void Antiprocrastinator::onConfigReloaded(const EnvConfig &config, const QStringList &changedKeys)
+{
+    // Что применяется без перезапуска, решает флаг hotReload в схеме .env
+    QStringList hotKeys;
+    for (const QString &key : changedKeys) {
+        if (isHotReloadConfigKey(key)) {
+            hotKeys.append(key);
+        } else {
+            qInfo() << "Ключ" << key << "из .env применится после перезапуска";
         }
     }
 
-    // Значения по умолчанию используются, если .env не найден или не содержит нужного ключа
-    m_quotesFilePath = "quotes.txt";
-    m_defaultTheme = "light";
-    m_defaultDuration = 25;
-    m_dbPath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation)
-               + "/antiprocrastinator/progress.db";
-
-    if (!envFile.isEmpty()) {
-        QFile file(envFile);
-        if (file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-            QTextStream in(&file);
-            in.setEncoding(QStringConverter::Utf8);
-
-            while (!in.atEnd()) {
-                QString line = in.readLine().trimmed();
-                // Пропускаем пустые строки и комментарии
-                if (line.isEmpty() || line.startsWith("#")) continue;
-
-                // Разбираем строки вида КЛЮЧ=ЗНАЧЕНИЕ
-                QRegularExpression re(R"(^\s*(\w+)\s*=\s*(.+?)\s*$)");
-                QRegularExpressionMatch match = re.match(line);
-                if (match.hasMatch()) {
-                    QString key = match.captured(1);
-                    QString value = match.captured(2).trimmed();
-                    // Убираем обрамляющие кавычки, если они есть
-                    if (value.startsWith("\"") && value.endsWith("\"")) {
-                        value = value.mid(1, value.length() - 2);
-                    }
-                    if (value.startsWith("'") && value.endsWith("'")) {
-                        value = value.mid(1, value.length() - 2);
-                    }
-
-                    // fromNativeSeparators заменяет обратные слеши (Windows) на прямые,
-                    // чтобы пути из .env корректно работали на macOS и Linux
-                    if (key == "QUOTES_FILE_PATH") m_quotesFilePath = QDir::fromNativeSeparators(value);
-                    else if (key == "DEFAULT_DURATION") m_defaultDuration = value.toInt();
-                    else if (key == "DEFAULT_THEME") m_defaultTheme = value;
-                    else if (key == "DB_PATH") m_dbPath = QDir::fromNativeSeparators(value);
-                }
-            }
-            file.close();
+    for (const QString &key : std::as_const(hotKeys)) {
+        if (key == "DEFAULT_THEME") {
+            m_defaultTheme = config.defaultTheme;
+        } else if (key == "DEFAULT_DURATION") {
+            m_defaultDuration = config.defaultDuration;
+        } else if (key == "QUOTES_FILE_PATH") {
+            // Во время загрузки путь читает фоновый поток, поэтому до конца запуска
+            // новый путь только запоминается; его применит finishStartupStage
+            m_pendingQuotesFilePath = config.quotesFilePath;
+            m_quotesFilePathPending = true;
+        } else {
+            qWarning() << "Ключ" << key << "помечен в схеме .env как применяемый сразу, но окно его не применяет";
         }
     }
 
-    // Создаём директорию для бд заранее, чтобы SQLite не упал при открытии
-    QFileInfo dbFileInfo(m_dbPath);
-    if (!dbFileInfo.dir().exists()) {
-        dbFileInfo.dir().mkpath(".");
+    // Пока запуск не завершён, новые значения по умолчанию применятся вместе с прочитанными из бд.
+    // Потом изменение в .env действует как выбор в настройках и сохраняется
+    if (m_finishedStages < 2) return;
+    if (hotKeys.contains("DEFAULT_THEME")) {
+        applyTheme(m_defaultTheme);
+    }
+    if (hotKeys.contains("DEFAULT_DURATION")) {
+        // Смена значения в поле перезапускает сессию на паузе, поэтому во время
+        // сессии длительность только запоминается и ставится при сбросе или завершении
+        m_defaultDurationPending = true;
+        if (!sessionInProgress()) applyPendingDuration();
     }
+    applyPendingQuotesFile();
 }
 
-bool Antiprocrastinator::initDatabase()
+void Antiprocrastinator::applyPendingQuotesFile()
 {
-    // Удаляем старое соединение, если оно осталось от предыдущего запуска
-    if (QSqlDatabase::contains("progress_db")) {
-        QSqlDatabase::removeDatabase("progress_db");
+    if (!m_quotesFilePathPending) return;
+    m_quotesFilePathPending = false;
+    m_quotesFilePath = m_pendingQuotesFilePath;
+
+    const QString path = QFileInfo(m_quotesFilePath).isAbsolute()
+                             ? m_quotesFilePath
+                             : QDir::cleanPath(QApplication::applicationDirPath() + "/" + m_quotesFilePath);
+    if (QFileInfo(path).isFile()) {
+        m_quotesTextPath = path;
+        m_quotesFileWatcher->setFilePath(m_quotesTextPath);
+        reloadQuotes();
+    } else {
+        qWarning() << "Новый файл цитат не найден:" << path;
     }
+}
 
-    m_db = QSqlDatabase::addDatabase("QSQLITE", "progress_db");
-    m_db.setDatabaseName(m_dbPath);
+void Antiprocrastinator::reloadQuotes()
+{
+    if (!m_quotesReady || m_quotesTextPath.isEmpty()) return;
+    Trace::Span span("перезагрузка цитат");
+
+    QElapsedTimer timer;
+    timer.start();
 
-    if (!m_db.open()) {
-        qWarning() << "Не удалось открыть БД:" << m_db.lastError().text();
-        return false;
+    QuoteDiff diff;
+    if (!m_quotes.reloadFile(m_quotesTextPath, &diff)) {
+        qWarning() << "Ошибка чтения файла цитат:" << m_quotesTextPath;
+        return;
     }
 
-    QSqlQuery query(m_db);
+    // reloadFile переносит открытия только из заменённого участка. Сверка с бд
+    // возвращает и цитату, которую убрали из файла, а потом вернули обратно
+    m_quotes.setUnlockedIds(m_unlockedIds);
+
+    // Индекс ссылается на номера строк и после правки файла устарел. Полная
+    // перестройка стоит O(коллекции), поэтому откладывается до первого поиска
+    m_quoteIndex.clear();
 
-    // Таблица sessions хранит каждую завершённую помодоро-сессию
-    if (!query.exec(R"(
-        CREATE TABLE IF NOT EXISTS sessions (
-            id INTEGER PRIMARY KEY AUTOINCREMENT,
-            start_time DATETIME DEFAULT CURRENT_TIMESTAMP,
-            duration_minutes INTEGER NOT NULL
-        )
-    )")) {
-        qWarning() << "Ошибка создания таблицы sessions:" << query.lastError();
-        return false;
+    if (m_quotesDialog) {
+        m_quotesDialog->quotesReloaded(diff);
     }
 
-    // Таблица settings хранит пользовательские предпочтения
-    if (!query.exec(R"(
-        CREATE TABLE IF NOT EXISTS settings (
-            key TEXT PRIMARY KEY,
-            value TEXT NOT NULL
-        )
-    )")) {
-        qWarning() << "Ошибка создания таблицы settings:" << query.lastError();
-        return false;
+    qInfo().noquote() << QString("Цитаты перечитаны за %1 мс: с позиции %2 заменено %3 строк на %4, всего %5")
+                             .arg(timer.nsecsElapsed() / 1e6, 0, 'f', 1)
+                             .arg(diff.first)
+                             .arg(diff.removed)
+                             .arg(diff.inserted)
+                             .arg(m_quotes.size());
+}
+
+void Antiprocrastinator::applyDatabase(const StartupSnapshot &snapshot)
+{
+    if (!snapshot.ok) {
+        qWarning() << "Не удалось открыть БД:" << snapshot.error;
+        QMessageBox::critical(this, "Ошибка базы данных",
+                              "Не удалось инициализировать базу данных прогресса.\n"
+                              "Приложение будет работать в режиме только для чтения.");
+    } else {
+        // Соединение главного потока для чтения уже открыто в фоне и передано сюда.
+        // Запись сессий и настроек идёт в отдельном потоке со своими соединениями
+        m_repository = snapshot.repository;
+        m_writer = new PersistenceWorker(m_pool, m_profile, this);
+        connect(m_writer, &PersistenceWorker::sessionRecorded, this, &Antiprocrastinator::onSessionRecorded);
+        connect(m_writer, &PersistenceWorker::writeFailed, this, &Antiprocrastinator::onWriteFailed);
+        connect(m_writer, &PersistenceWorker::countersRepaired, this, &Antiprocrastinator::onCountersRepaired);
     }
+    m_settings = new SettingsStore(m_writer, m_profile, this);
+    updateWindowTitle();
 
-    // Вставляем начальные значения, только если записей ещё нет (INSERT OR IGNORE)
-    query.prepare("INSERT OR IGNORE INTO settings (key, value) VALUES (:key, :value)");
-    query.bindValue(":key", "theme");
-    query.bindValue(":value", m_defaultTheme);
-    query.exec();
+    // Если БД недоступна, то начинаем с нуля, без сохранения
+    if (!m_writer) {
+        m_sessionsCompleted = 0;
+        m_pomodoroMinutes = m_defaultDuration;
+        return;
+    }
+    applySnapshot(snapshot);
+}
+
+void Antiprocrastinator::applySnapshot(const StartupSnapshot &snapshot)
+{
+    // Количество завершённых сессий читается из готового счётчика одной строкой,
+    // без COUNT(*) по всей истории
+    m_sessionsCompleted = snapshot.sessionsCompleted;
+    m_unlockedIds = snapshot.unlockedIds;
+    m_unlocksMigrated = snapshot.unlocksMigrated;
+    m_journalCommittedKey = snapshot.journalCommittedKey;
+
+    // Восстанавливаем сохранённые настройки темы и длительности
+    if (snapshot.themeFound) {
+        m_defaultTheme = snapshot.theme;
+        m_settings->load("theme", m_defaultTheme);
+    } else {
+        m_defaultTheme = "light";
+    }
+
+    m_pomodoroMinutes = m_defaultDuration;
+    if (snapshot.durationFound) {
+        m_settings->load("duration", snapshot.duration);
+        bool ok;
+        const int minutes = snapshot.duration.toInt(&ok);
+        if (ok) m_pomodoroMinutes = minutes;
+    }
+
+    m_sessionCounterLabel->setText(QString("Сессий завершено: %1").arg(m_sessionsCompleted));
+    applyTheme(m_defaultTheme);
+    m_durationSpinBox->setValue(m_pomodoroMinutes);
+}
+
+void Antiprocrastinator::finishStartupStage()
+{
+    if (++m_finishedStages < 2) return;
 
-    query.prepare("INSERT OR IGNORE INTO settings (key, value) VALUES (:key, :value)");
-    query.bindValue(":key", "duration");
-    query.bindValue(":value", QString::number(m_defaultDuration));
-    query.exec();
+    {
+        StartupTrace::Scope stage(m_trace, "восстановление прогресса");
+        loadProgress();
+        setStartupControlsEnabled(true);
+    }
+    // Путь к цитатам мог смениться в .env, пока они загружались
+    applyPendingQuotesFile();
+    m_trace.mark("запуск завершён");
+    qInfo().noquote() << m_trace.report();
+}
 
-    return true;
+void Antiprocrastinator::setStartupControlsEnabled(bool enabled)
+{
+    // До окончания загрузки нельзя начать сессию и менять настройки:
+    // их значения ещё не прочитаны из бд
+    m_startButton->setEnabled(enabled);
+    m_resetButton->setEnabled(enabled);
+    m_themeComboBox->setEnabled(enabled);
+    m_durationSpinBox->setEnabled(enabled);
+    m_viewCollectionAction->setEnabled(enabled);
+    m_viewStatsAction->setEnabled(enabled);
+    m_profileMenu->setEnabled(enabled);
 }
 
 void Antiprocrastinator::loadQuotes()
@@ -218,6 +433,28 @@ void Antiprocrastinator::loadQuotes()
         qDebug() << "Ищу файл цитат:" << c;
     }
 
+    // За текстовым файлом следим и после запуска, даже если загружен пакет
+    m_quotesTextPath.clear();
+    for (const QString &candidate : candidates) {
+        if (QFileInfo(candidate).isFile()) {
+            m_quotesTextPath = candidate;
+            break;
+        }
+    }
+
+    // Рядом с текстовым файлом может лежать пакет .qpack, собранный при сборке.
+    // Он предпочтительнее, если не старше самого текста: загружается почти без разбора
+    for (const QString &candidate : candidates) {
+        const QFileInfo textInfo(candidate);
+        const QFileInfo packInfo(textInfo.path() + "/" + textInfo.completeBaseName() + ".qpack");
+        if (packInfo.isFile()
+            && (!textInfo.exists() || packInfo.lastModified() >= textInfo.lastModified())
+            && m_quotes.loadPack(packInfo.filePath())) {
+            qDebug() << "Загружен пакет цитат:" << packInfo.filePath() << ", цитат:" << m_quotes.size();
+            return;
+        }
+    }
+
     QString quotesFile;
     for (const QString &candidate : candidates) {
         QFileInfo info(candidate);
@@ -230,118 +467,148 @@ void Antiprocrastinator::loadQuotes()
 
     // Если файл так и не нашли, то используем встроенный запасной набор цитат
     if (quotesFile.isEmpty()) {
-        m_allQuotes = fallback;
+        m_quotes.setQuotes(fallback);
         qWarning() << "Файл цитат не найден, используются встроенные фразы";
         return;
     }
 
-    QFile file(quotesFile);
-    if (file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        QTextStream in(&file);
-        in.setEncoding(QStringConverter::Utf8);
-
-        while (!in.atEnd()) {
-            QString line = in.readLine().trimmed();
-            // Пропускаем пустые строки и строки-комментарии
-            if (!line.isEmpty() && !line.startsWith("#")) {
-                m_allQuotes.append(line);
-            }
-        }
-        file.close();
-        qDebug() << "Загружено цитат:" << m_allQuotes.size();
+    // Файл отображается в память, в QString цитаты декодируются только при показе
+    if (m_quotes.loadFile(quotesFile)) {
+        qDebug() << "Загружено цитат:" << m_quotes.size();
     } else {
         qWarning() << "Ошибка чтения файла цитат:" << quotesFile;
-        m_allQuotes = fallback;
+        m_quotes.setQuotes(fallback);
     }
 }
 
 void Antiprocrastinator::loadProgress()
 {
-    // Если БД недоступна, то начинаем с нуля, без сохранения
-    if (!m_db.isOpen()) {
-        m_sessionsCompleted = 0;
-        m_pomodoroMinutes = m_defaultDuration;
-        m_unlockedCount = 0;
-        m_quotesWithStatus.clear();
-        for (const QString &quote : m_allQuotes) {
-            m_quotesWithStatus.append({quote, false});
+    // Бд и цитаты уже загружены. Открытые цитаты ищутся по идентификаторам
+    // через индекс хранилища, так что восстановление зависит от числа открытых, а не от размера коллекции
+    if (m_unlocksMigrated) {
+        m_quotes.setUnlockedIds(m_unlockedIds);
+    } else {
+        // База из версии, где хранилось только число сессий: открытыми были первые цитаты файла.
+        // Запоминаем их идентификаторы, чтобы дальше правка файла их не сдвигала
+        m_quotes.setUnlockedCount(m_sessionsCompleted);
+        m_unlockedIds.clear();
+        for (int i = 0; i < m_quotes.unlockedCount(); ++i) {
+            m_unlockedIds.append(m_quotes.id(i));
         }
-        return;
-    }
 
-    // Считаем общее количество завершённых сессий
-    QSqlQuery query(m_db);
-    if (query.exec("SELECT COUNT(*) FROM sessions") && query.next()) {
-        m_sessionsCompleted = query.value(0).toInt();
-    } else {
-        m_sessionsCompleted = 0;
+        WriteCommand command;
+        command.type = WriteCommand::MigrateUnlocks;
+        command.profile = m_profile;
+        command.quoteIds = m_unlockedIds;
+        m_writer->enqueue(command);
+        m_unlocksMigrated = true;
     }
 
-    // Восстанавливаем сохранённые настройки темы и длительности
-    query.prepare("SELECT value FROM settings WHERE key = 'theme'");
-    if (query.exec() && query.next()) {
-        m_defaultTheme = query.value(0).toString();
+    // Показываем последнюю открытую цитату, либо приглашение начать
+    if (m_quotes.lastUnlocked() >= 0) {
+        m_quoteBanner->setText(QString("❝%1❞").arg(m_quotes.text(m_quotes.lastUnlocked())));
     } else {
-        m_defaultTheme = "light";
+        m_quoteBanner->setText("🍅 Начни первую сессию, чтобы открыть цитату!");
     }
 
-    query.prepare("SELECT value FROM settings WHERE key = 'duration'");
-    if (query.exec() && query.next()) {
-        bool ok;
-        int duration = query.value(0).toInt(&ok);
-        m_pomodoroMinutes = ok ? duration : m_defaultDuration;
-    } else {
-        m_pomodoroMinutes = m_defaultDuration;
-    }
+    // Журнал проигрывается после цитат: восстановленная сессия тоже открывает цитату
+    recoverSession();
 
-    // Количество открытых цитат = количеству завершённых сессий, но не больше числа цитат
-    m_unlockedCount = qMin(m_sessionsCompleted, m_allQuotes.size());
+    qDebug() << "Прогресс загружен: сессий =" << m_sessionsCompleted
+             << ", открыто цитат =" << m_quotes.unlockedCount()
+             << ", всего цитат =" << m_quotes.size();
+}
 
-    // Помечаем первые m_unlockedCount цитат как открытые
-    m_quotesWithStatus.clear();
-    for (int i = 0; i < m_allQuotes.size(); ++i) {
-        bool unlocked = (i < m_unlockedCount);
-        m_quotesWithStatus.append({m_allQuotes[i], unlocked});
+void Antiprocrastinator::recoverSession()
+{
+    // Журнал лежит рядом с бд профиля и без неё не ведётся: дописывать потерянное некуда
+    if (!m_writer) return;
+
+    // Журнал профиля, к которому вернулись, уже проигран, а прерванной сессии
+    // в нём нет: профиль нельзя сменить посреди сессии
+    m_journal = m_journals.value(m_profile);
+    if (m_journal) return;
+
+    m_journal = new SessionJournal(this);
+    if (!m_journal->open(m_pool->shardPath(m_profile) + ".sessionlog", m_journalCommittedKey)) {
+        qWarning() << "Журнал сессий недоступен, прерванные сессии не восстанавливаются:" << m_journal->lastError();
+        delete m_journal;
+        m_journal = nullptr;
+        return;
     }
+    m_journals.insert(m_profile, m_journal);
+    const SessionJournal::Recovery &recovery = m_journal->recovery();
 
-    m_sessionCounterLabel->setText(QString("Сессий завершено: %1").arg(m_sessionsCompleted));
-    m_durationSpinBox->setValue(m_pomodoroMinutes);
+    // Сессии, завершённые перед падением, но не дошедшие до sessions
+    for (const SessionJournal::Record &record : recovery.finished) {
+        commitSession(qMax(1, int(record.durationMs / 60000)), record.key);
+    }
+    if (!recovery.finished.isEmpty()) {
+        qInfo() << "Из журнала дописано завершённых сессий:" << recovery.finished.size();
+    }
+    if (!recovery.active) return;
 
-    // Показываем последнюю открытую цитату, либо приглашение начать
-    if (m_unlockedCount > 0) {
-        m_quoteLabel->setText(QString("❝%1❞").arg(m_quotesWithStatus[m_unlockedCount - 1].first));
-    } else {
-        m_quoteLabel->setText("🍅 Начни первую сессию, чтобы открыть цитату!");
+    const SessionJournal::Record &session = recovery.session;
+    const int minutes = qMax(1, int(session.durationMs / 60000));
+    if (session.elapsedMs >= session.durationMs) {
+        // Время вышло, но завершение записать не успели
+        commitSession(minutes, m_journal->finish(session.elapsedMs));
+        return;
     }
 
-    qDebug() << "Прогресс загружен: сессий =" << m_sessionsCompleted
-             << ", открыто цитат =" << m_unlockedCount
-             << ", всего цитат =" << m_allQuotes.size();
+    // Отсчёт продолжается с последней записи журнала, на паузе: время простоя
+    // после падения в работу не засчитывается, продолжать ли — решает пользователь
+    m_pomodoroMinutes = minutes;
+    {
+        const QSignalBlocker blocker(m_durationSpinBox);
+        m_durationSpinBox->setValue(minutes);
+    }
+    m_engine->restore(session.durationMs, session.elapsedMs);
+    updateDisplay();
+    m_startButton->setText("▶️ Продолжить");
+    m_quoteBanner->setText(QString("⏸ Прерванная сессия восстановлена, осталось %1").arg(m_timeDisplay->text()));
+
+    qInfo().noquote() << QString("Восстановлена прерванная сессия: отработано %1 с из %2, прервана %3 (%4)")
+                             .arg(session.elapsedMs / 1000)
+                             .arg(session.durationMs / 1000)
+                             .arg(QDateTime::fromMSecsSinceEpoch(session.wallMs).toString(Qt::ISODate),
+                                  recovery.wasRunning ? "во время отсчёта" : "на паузе");
 }
 
-void Antiprocrastinator::saveProgress()
+void Antiprocrastinator::commitSession(int durationMinutes, qint64 journalKey)
 {
-    if (!m_db.isOpen()) return;
-
-    // Оборачиваем оба UPDATE в транзакцию, чтобы настройки сохранялись атомарно
-    m_db.transaction();
+    // Состояние в памяти обновляется сразу, а запись в бд уходит в поток записи,
+    // чтобы медленный диск не задерживал появление диалога с цитатой
+    m_sessionsCompleted++;
+    m_sessionCounterLabel->setText(QString("Сессий завершено: %1").arg(m_sessionsCompleted));
 
-    QSqlQuery query(m_db);
-    query.prepare("UPDATE settings SET value = :value WHERE key = 'theme'");
-    query.bindValue(":value", m_themeComboBox->currentData().toString());
-    if (!query.exec()) {
-        m_db.rollback();
-        return;
+    // Открываем следующую цитату, если в коллекции ещё есть закрытые
+    const int unlocked = m_quotes.unlockNext();
+    if (unlocked >= 0) {
+        m_unlockedIds.append(m_quotes.id(unlocked));
     }
 
-    query.prepare("UPDATE settings SET value = :value WHERE key = 'duration'");
-    query.bindValue(":value", QString::number(m_durationSpinBox->value()));
-    if (!query.exec()) {
-        m_db.rollback();
-        return;
+    if (m_writer) {
+        WriteCommand command;
+        command.type = WriteCommand::RecordSession;
+        command.profile = m_profile;
+        command.durationMinutes = durationMinutes;
+        command.unlocksQuote = unlocked >= 0;
+        command.quoteId = command.unlocksQuote ? m_unlockedIds.constLast() : 0;
+        command.journalKey = journalKey;
+        m_writer->enqueue(command);
     }
+}
+
+void Antiprocrastinator::saveProgress()
+{
+    // До применения бд сохранять нечего: настройки ещё не прочитаны
+    if (!m_settings) return;
 
-    m_db.commit();
+    // Значения только запоминаются: хранилище само запишет их одной транзакцией,
+    // когда изменения прекратятся
+    m_settings->setValues({{"theme", m_themeComboBox->currentData().toString()},
+                           {"duration", QString::number(m_durationSpinBox->value())}});
 }
 
 void Antiprocrastinator::setupUI()
@@ -352,21 +619,19 @@ void Antiprocrastinator::setupUI()
     QWidget *centralWidget = new QWidget(this);
     setCentralWidget(centralWidget);
 
-    // Большой таймер по центру
-    m_timeLabel = new QLabel("25:00", centralWidget);
-    m_timeLabel->setAlignment(Qt::AlignCenter);
-    m_timeLabel->setStyleSheet("QLabel { font-size: 72px; font-weight: bold; margin: 10px 0; }");
+    // Большой таймер по центру: размер табло не зависит от времени на нём
+    m_timeDisplay = new CountdownDisplay(centralWidget);
+    m_timeDisplay->setFont(Theme::timeFont());
 
-    m_sessionCounterLabel = new QLabel("Сессий завершено: 0", centralWidget);
+    // До загрузки бд вместо числа сессий показывается заглушка
+    m_sessionCounterLabel = new QLabel("Сессий завершено: …", centralWidget);
     m_sessionCounterLabel->setAlignment(Qt::AlignCenter);
-    m_sessionCounterLabel->setStyleSheet("QLabel { font-size: 18px; color: #3498db; margin-bottom: 15px; }");
+    m_sessionCounterLabel->setFont(Theme::counterFont());
+    m_sessionCounterLabel->setContentsMargins(0, 0, 0, 15);
 
     // Область для отображения мотивационных цитат
-    m_quoteLabel = new QLabel("🍅 Начни первую сессию, чтобы открыть цитату!", centralWidget);
-    m_quoteLabel->setAlignment(Qt::AlignCenter);
-    m_quoteLabel->setWordWrap(true);
-    m_quoteLabel->setMinimumHeight(70);
-    m_quoteLabel->setStyleSheet("QLabel { font-size: 16px; font-style: italic; color: #7f8c8d; padding: 10px; }");
+    m_quoteBanner = new QuoteBanner(centralWidget);
+    m_quoteBanner->setText("Загрузка цитат…");
 
     m_startButton = new QPushButton("▶️ Старт", centralWidget);
     m_pauseButton = new QPushButton("⏸ Пауза", centralWidget);
@@ -396,9 +661,9 @@ void Antiprocrastinator::setupUI()
     settingsGroup->setLayout(settingsLayout);
 
     QVBoxLayout *mainLayout = new QVBoxLayout(centralWidget);
-    mainLayout->addWidget(m_timeLabel);
+    mainLayout->addWidget(m_timeDisplay);
     mainLayout->addWidget(m_sessionCounterLabel);
-    mainLayout->addWidget(m_quoteLabel);
+    mainLayout->addWidget(m_quoteBanner);
     mainLayout->addSpacing(15);
     mainLayout->addLayout(buttonLayout);
     mainLayout->addSpacing(15);
@@ -415,9 +680,29 @@ void Antiprocrastinator::setupMenuBar()
 
     // Меню для просмотра коллекции открытых цитат
     QMenu *quotesMenu = menuBar->addMenu("📚 Цитаты");
-    QAction *viewCollectionAction = new QAction("Моя коллекция...", this);
-    connect(viewCollectionAction, &QAction::triggered, this, &Antiprocrastinator::showQuotesCollection);
-    quotesMenu->addAction(viewCollectionAction);
+    m_viewCollectionAction = new QAction("Моя коллекция...", this);
+    connect(m_viewCollectionAction, &QAction::triggered, this, &Antiprocrastinator::showQuotesCollection);
+    quotesMenu->addAction(m_viewCollectionAction);
+
+    // Статистика по дням, неделям и месяцам строится по свёрткам в бд
+    QMenu *statsMenu = menuBar->addMenu("📈 Статистика");
+    m_viewStatsAction = new QAction("Мой прогресс...", this);
+    connect(m_viewStatsAction, &QAction::triggered, this, &Antiprocrastinator::showStatistics);
+    statsMenu->addAction(m_viewStatsAction);
+
+    // Профили: у каждого своя база, список перечитывается при каждом открытии меню
+    m_profileMenu = menuBar->addMenu("👤 Профиль");
+    connect(m_profileMenu, &QMenu::aboutToShow, this, &Antiprocrastinator::updateProfileMenu);
+    updateProfileMenu();
+
+    // Трей и отчёт о пробуждениях: сколько раз таймер будил процесс
+    QMenu *timerMenu = menuBar->addMenu("🍅 Таймер");
+    m_trayAction = new QAction("Свернуть в трей", this);
+    connect(m_trayAction, &QAction::triggered, this, &Antiprocrastinator::hideToTray);
+    timerMenu->addAction(m_trayAction);
+    QAction *wakeupsAction = new QAction("Пробуждения таймера...", this);
+    connect(wakeupsAction, &QAction::triggered, this, &Antiprocrastinator::showWakeupReport);
+    timerMenu->addAction(wakeupsAction);
 
     QMenu *helpMenu = menuBar->addMenu("❓ Помощь");
     QAction *aboutAction = new QAction("О программе", this);
@@ -432,65 +717,306 @@ void Antiprocrastinator::setupMenuBar()
     helpMenu->addAction(aboutAction);
 }
 
+void Antiprocrastinator::updateProfileMenu()
+{
+    // Перечень профилей — это файлы шардов; каталог маленький, чтение дешёвое
+    m_profileMenu->clear();
+    qDeleteAll(m_profileMenu->findChildren<QActionGroup *>(QString(), Qt::FindDirectChildrenOnly));
+    auto *group = new QActionGroup(m_profileMenu);
+    QStringList profiles = m_pool->profiles();
+    if (!profiles.contains(m_profile)) profiles.append(m_profile);
+    for (const QString &profile : std::as_const(profiles)) {
+        QAction *action = m_profileMenu->addAction(profile == ConnectionPool::kDefaultProfile ? "Основной" : profile);
+        action->setCheckable(true);
+        action->setChecked(profile == m_profile);
+        group->addAction(action);
+        connect(action, &QAction::triggered, this, [this, profile]() { switchProfile(profile); });
+    }
+
+    m_profileMenu->addSeparator();
+    m_profileMenu->addAction("Новый профиль...", this, &Antiprocrastinator::createProfile);
+    m_profilesSummaryAction = m_profileMenu->addAction("Сводка по всем профилям...", this,
+                                                       &Antiprocrastinator::showProfilesSummary);
+    m_profilesSummaryAction->setEnabled(!m_summaryFuture.isRunning());
+}
+
+bool Antiprocrastinator::sessionInProgress() const
+{
+    return m_engine->isRunning()
+           || (m_journal && m_journal->hasActiveSession())
+           || m_engine->remainingMs() < m_engine->durationMs();
+}
+
+void Antiprocrastinator::updateWindowTitle()
+{
+    QString title = "Антипрокрастинатор 🍅";
+    if (m_profile != ConnectionPool::kDefaultProfile) title += " — " + m_profile;
+    setWindowTitle(title);
+}
+
+void Antiprocrastinator::switchProfile(const QString &profile)
+{
+    if (profile == m_profile || !m_writer || m_profileFuture.isRunning()) return;
+    if (sessionInProgress()) {
+        QMessageBox::information(this, "Профиль",
+                                 "Сначала завершите или сбросьте текущую сессию: "
+                                 "она записывается в базу текущего профиля.");
+        return;
+    }
+    Trace::instant("профиль: переключение");
+
+    // Несохранённые настройки уходят в базу прежнего профиля
+    saveProgress();
+    m_settings->flush();
+    setStartupControlsEnabled(false);
+    m_sessionCounterLabel->setText("Сессий завершено: …");
+
+    // Снимок нового профиля читается в пуле потоков, как при запуске: поток
+    // интерфейса не ждёт ни открытия шарда, ни создания схемы
+    auto *watcher = new QFutureWatcher<StartupSnapshot>(this);
+    connect(watcher, &QFutureWatcher<StartupSnapshot>::finished, this, [this, watcher]() {
+        watcher->deleteLater();
+        applyProfile(watcher->result());
+    });
+    m_profileFuture = QtConcurrent::run(m_pool->readers(), readStartupSnapshot, m_pool, profile,
+                                        m_defaultTheme, m_defaultDuration, thread());
+    watcher->setFuture(m_profileFuture);
+}
+
+void Antiprocrastinator::applyProfile(const StartupSnapshot &snapshot)
+{
+    Trace::Span span("профиль: применение");
+    // Схема и соединение главного потока с профилем уже готовы: их открыл фоновый снимок
+    if (!snapshot.ok) {
+        qWarning() << "Не удалось открыть профиль" << snapshot.profile << ":" << snapshot.error;
+        QMessageBox::warning(this, "Профиль", QString("Не удалось открыть профиль «%1».").arg(snapshot.profile));
+        m_sessionCounterLabel->setText(QString("Сессий завершено: %1").arg(m_sessionsCompleted));
+        setStartupControlsEnabled(true);
+        return;
+    }
+
+    // Соединение главного потока с прежним профилем больше не нужно и закрывается
+    // здесь, в потоке-владельце; при возврате к профилю его снова откроет фоновый снимок
+    m_pool->release(m_profile);
+    m_repository = snapshot.repository;
+    m_profile = snapshot.profile;
+    m_journal = nullptr;   // Журнал прежнего профиля больше не получает переходов
+    m_settings->setProfile(m_profile);
+    m_writer->openProfile(m_profile);
+    updateWindowTitle();
+
+    applySnapshot(snapshot);
+    resetTimer();
+    // Открытые цитаты и журнал нового профиля
+    loadProgress();
+    setStartupControlsEnabled(true);
+    qInfo() << "Профиль переключён:" << m_profile << ", соединений в пуле:" << m_pool->connectionCount();
+}
+
+void Antiprocrastinator::createProfile()
+{
+    bool ok = false;
+    const QString name = QInputDialog::getText(this, "Новый профиль",
+                                               "Имя профиля (буквы, цифры, '_' и '-'):",
+                                               QLineEdit::Normal, QString(), &ok).trimmed();
+    if (!ok || name.isEmpty()) return;
+    if (!ConnectionPool::isValidProfileName(name)) {
+        QMessageBox::warning(this, "Новый профиль",
+                             QString("Имя может содержать только буквы, цифры, '_' и '-', не длиннее %1 символов.")
+                                 .arg(ConnectionPool::kMaxProfileNameLength));
+        return;
+    }
+    // База профиля создаётся при первом открытии
+    switchProfile(name);
+}
+
+void Antiprocrastinator::showProfilesSummary()
+{
+    if (!m_writer) {
+        QMessageBox::information(this, "Сводка по профилям", "База данных недоступна, статистика не ведётся.");
+        return;
+    }
+    if (m_summaryFuture.isRunning()) return;
+    m_profilesSummaryAction->setEnabled(false);
+
+    // Шарды независимы, поэтому каждый профиль считается в своём потоке пула;
+    // окно остаётся отзывчивым, пока идут запросы
+    QElapsedTimer timer;
+    timer.start();
+    auto *watcher = new QFutureWatcher<ProfileSummary>(this);
+    connect(watcher, &QFutureWatcher<ProfileSummary>::finished, this, [this, watcher, timer]() {
+        watcher->deleteLater();
+        if (m_profilesSummaryAction) m_profilesSummaryAction->setEnabled(true);
+
+        const QList<ProfileSummary> summaries = watcher->future().results();
+        auto line = [](const QString &name, const ProfileSummary &summary) {
+            return QString("%1: сегодня %2 мин, за неделю %3 мин, всего %4 сессий (%5 мин), серия %6 дн.")
+                .arg(name)
+                .arg(summary.today.minutes)
+                .arg(summary.week.minutes)
+                .arg(summary.sessions)
+                .arg(summary.total.minutes)
+                .arg(summary.streaks.current);
+        };
+        QStringList lines;
+        for (const ProfileSummary &summary : summaries) {
+            const QString name = (summary.profile == m_profile ? "• " : "  ")
+                                 + (summary.profile == ConnectionPool::kDefaultProfile ? QString("Основной")
+                                                                                        : summary.profile);
+            lines << (summary.ok ? line(name, summary) : QString("%1: недоступен (%2)").arg(name, summary.error));
+        }
+        lines << QString() << line("Все профили", ProfileStats::combine(summaries));
+
+        qInfo().noquote() << QString("Сводка по %1 профилям собрана за %2 мс").arg(summaries.size()).arg(timer.elapsed());
+        QMessageBox::information(this, "Сводка по профилям", lines.join('\n'));
+    });
+    // Сессия, завершённая только что, могла ещё не дойти до бд из потока записи
+    m_summaryFuture = ProfileStats::collect(m_pool, m_pool->profiles(), QDate::currentDate());
+    watcher->setFuture(m_summaryFuture);
+}
+
+void Antiprocrastinator::setupTray()
+{
+    // Без трея пункт меню выключен, а свёрнутое окно просыпается раз в минуту
+    if (!QSystemTrayIcon::isSystemTrayAvailable()) {
+        m_trayAction->setEnabled(false);
+        return;
+    }
+
+    m_trayIcon = new QSystemTrayIcon(makeTrayIcon(), this);
+    auto *menu = new QMenu(this);
+    menu->addAction("Показать окно", this, &Antiprocrastinator::restoreFromTray);
+    menu->addAction("Выход", qApp, &QApplication::quit);
+    m_trayIcon->setContextMenu(menu);
+    connect(m_trayIcon, &QSystemTrayIcon::activated, this, [this](QSystemTrayIcon::ActivationReason reason) {
+        if (reason == QSystemTrayIcon::Trigger || reason == QSystemTrayIcon::DoubleClick) {
+            restoreFromTray();
+        }
+    });
+}
+
+void Antiprocrastinator::hideToTray()
+{
+    if (!m_trayIcon) return;
+
+    // Подсказка считается один раз: в трее нет тиков, которые бы её обновляли
+    QString tip = "Антипрокрастинатор";
+    if (m_engine->isRunning()) {
+        tip += QString("\nСессия закончится в %1")
+                   .arg(QTime::currentTime().addMSecs(int(m_engine->remainingMs())).toString("HH:mm"));
+    } else if (m_engine->remainingMs() < m_engine->durationMs()) {
+        tip += "\nСессия на паузе";
+    }
+    m_trayIcon->setToolTip(tip);
+
+    // Значок показывается раньше, чем окно прячется: по нему hideEvent узнаёт режим трея
+    m_trayIcon->show();
+    hide();
+}
+
+void Antiprocrastinator::restoreFromTray()
+{
+    if (m_trayIcon) m_trayIcon->hide();
+    showNormal();
+    raise();
+    activateWindow();
+}
+
+void Antiprocrastinator::showWakeupReport()
+{
+    QMessageBox::information(this, "Пробуждения таймера",
+                             wakeupSummary() + "\n\n"
+                             "Пока окно на экране, таймер просыпается раз в секунду, "
+                             "пока свёрнуто — раз в минуту, а в трее — только в конце сессии.");
+}
+
+void Antiprocrastinator::changeEvent(QEvent *event)
+{
+    QMainWindow::changeEvent(event);
+    if (event->type() == QEvent::WindowStateChange) {
+        updateWakePolicy();
+    }
+}
+
+void Antiprocrastinator::showEvent(QShowEvent *event)
+{
+    QMainWindow::showEvent(event);
+    updateWakePolicy();
+}
+
+void Antiprocrastinator::hideEvent(QHideEvent *event)
+{
+    QMainWindow::hideEvent(event);
+    updateWakePolicy();
+}
+
+void Antiprocrastinator::updateWakePolicy()
+{
+    // Видимое окно — раз в секунду. Свёрнутое — раз в минуту ради контрольных
+    // точек журнала. Из трея отсчёт не виден вовсе, и движок просыпается один
+    // раз, в момент дедлайна
+    qint64 interval = TimerEngine::kTickMs;
+    if (!isVisible() && m_trayIcon && m_trayIcon->isVisible()) {
+        interval = 0;
+    } else if (!isVisible() || isMinimized()) {
+        interval = kHiddenWakeMs;
+    }
+    if (interval == m_engine->wakeInterval()) return;
+    m_engine->setWakeInterval(interval);
+    Trace::counter("интервал пробуждений таймера", interval);
+
+    if (interval == TimerEngine::kTickMs) {
+        // Окно снова на экране: табло сразу догоняет движок, не дожидаясь тика
+        updateDisplay();
+    } else if (m_journal && m_engine->isRunning()) {
+        // Дальше контрольные точки будут реже или не будут вовсе
+        m_journal->checkpoint(m_engine->elapsedMs(), true);
+    }
+}
+
+QString Antiprocrastinator::wakeupSummary() const
+{
+    const qint64 activeMs = m_engine->activeMs();
+    const quint64 wakeups = m_engine->wakeups();
+    const QString perHour = activeMs > 0 ? QString::number(double(wakeups) * 3600000.0 / double(activeMs), 'f', 0)
+                                         : QString("—");
+    return QString("Пробуждений таймера: %1 за %2 мин отсчёта, в час: %3")
+        .arg(wakeups)
+        .arg(activeMs / 60000)
+        .arg(perHour);
+}
+
 void Antiprocrastinator::applyTheme(const QString &themeName)
 {
-    QPalette palette;
-    if (themeName == "dark") {
-        // В тёмной теме тёмно-серый фон и светлый текст
-        palette.setColor(QPalette::Window, QColor(53, 53, 53));
-        palette.setColor(QPalette::WindowText, Qt::white);
-        palette.setColor(QPalette::Base, QColor(35, 35, 35));
-        palette.setColor(QPalette::AlternateBase, QColor(53, 53, 53));
-        palette.setColor(QPalette::ToolTipBase, Qt::white);
-        palette.setColor(QPalette::ToolTipText, Qt::white);
-        palette.setColor(QPalette::Text, Qt::white);
-        palette.setColor(QPalette::Button, QColor(70, 70, 70));
-        palette.setColor(QPalette::ButtonText, Qt::white);
-        palette.setColor(QPalette::BrightText, Qt::red);
-        palette.setColor(QPalette::Highlight, QColor(42, 130, 218));
-        palette.setColor(QPalette::HighlightedText, Qt::black);
-
-        m_timeLabel->setStyleSheet("QLabel { font-size: 72px; font-weight: bold; color: #4fc3f7; margin: 10px 0; }");
-        m_sessionCounterLabel->setStyleSheet("QLabel { font-size: 18px; color: #64b5f6; margin-bottom: 15px; }");
-        m_quoteLabel->setStyleSheet("QLabel { font-size: 16px; font-style: italic; color: #b0bec5; padding: 10px; min-height: 70px; }");
-    } else {
-        // В светлой теме ветло-серый фон и тёмный текст
-        palette.setColor(QPalette::Window, QColor(245, 247, 250));
-        palette.setColor(QPalette::WindowText, QColor(44, 62, 80));
-        palette.setColor(QPalette::Base, Qt::white);
-        palette.setColor(QPalette::AlternateBase, QColor(240, 240, 240));
-        palette.setColor(QPalette::ToolTipBase, Qt::white);
-        palette.setColor(QPalette::ToolTipText, Qt::black);
-        palette.setColor(QPalette::Text, QColor(44, 62, 80));
-        palette.setColor(QPalette::Button, QColor(230, 230, 230));
-        palette.setColor(QPalette::ButtonText, QColor(44, 62, 80));
-        palette.setColor(QPalette::BrightText, Qt::red);
-        palette.setColor(QPalette::Highlight, QColor(52, 152, 219));
-        palette.setColor(QPalette::HighlightedText, Qt::white);
-
-        m_timeLabel->setStyleSheet("QLabel { font-size: 72px; font-weight: bold; color: #2c3e50; margin: 10px 0; }");
-        m_sessionCounterLabel->setStyleSheet("QLabel { font-size: 18px; color: #3498db; margin-bottom: 15px; }");
-        m_quoteLabel->setStyleSheet("QLabel { font-size: 16px; font-style: italic; color: #7f8c8d; padding: 10px; min-height: 70px; }");
-    }
-
-    qApp->setPalette(palette);
-    qApp->setStyleSheet(themeName == "dark" ?
-                            "QToolTip { color: #ffffff; background-color: #2a2a2a; border: 1px solid white; padding: 5px; border-radius: 3px; }" :
-                            "QToolTip { color: #000000; background-color: #ffffff; border: 1px solid #bdc3c7; padding: 5px; border-radius: 3px; }");
-
-    int index = (themeName == "dark") ? 1 : 0;
-    m_themeComboBox->setCurrentIndex(index);
+    // Темы собраны заранее, здесь только подставляются готовые палитры.
+    // Цвета меток заданы ролью палитры, а не таблицей стилей, поэтому
+    // переключение не вызывает разбор CSS и повторный polish виджетов
+    const Theme &theme = Theme::byName(themeName);
+    if (m_theme == &theme) return;
+    m_theme = &theme;
+    Trace::Span span("применение темы");
+
+    Theme::apply(theme);
+    m_timeDisplay->setPalette(theme.timePalette());
+    m_sessionCounterLabel->setPalette(theme.counterPalette());
+    m_quoteBanner->setTheme(theme);
+
+    m_themeComboBox->setCurrentIndex(theme.isDark() ? 1 : 0);
 }
 
 void Antiprocrastinator::startTimer()
 {
-    if (!m_isRunning) {
-        // Если время уже вышло, то начинаем заново с полной длительности
-        if (m_remainingTime <= QTime(0, 0, 0)) {
-            m_remainingTime = QTime(0, m_pomodoroMinutes, 0);
+    if (!m_engine->isRunning()) {
+        // Если время уже вышло, то движок сам начнёт заново с полной длительности
+        m_engine->start();
+        if (m_journal) {
+            // Продолжение после паузы пишется в ту же сессию журнала, иначе начинается новая
+            if (m_journal->hasActiveSession()) {
+                m_journal->resume(m_engine->elapsedMs());
+            } else {
+                m_journal->start(m_engine->durationMs());
+            }
         }
-        m_timer->start();
-        m_isRunning = true;
         m_startButton->setEnabled(false);
         m_pauseButton->setEnabled(true);
         m_startButton->setText("▶️ В работе...");
@@ -501,9 +1027,9 @@ void Antiprocrastinator::startTimer()
 
 void Antiprocrastinator::pauseTimer()
 {
-    if (m_isRunning) {
-        m_timer->stop();
-        m_isRunning = false;
+    if (m_engine->isRunning()) {
+        m_engine->pause();
+        if (m_journal) m_journal->pause(m_engine->elapsedMs());
         m_startButton->setEnabled(true);
         m_pauseButton->setEnabled(false);
         m_startButton->setText("▶️ Продолжить");
@@ -513,9 +1039,9 @@ void Antiprocrastinator::pauseTimer()
 
 void Antiprocrastinator::resetTimer()
 {
-    m_timer->stop();
-    m_isRunning = false;
-    m_remainingTime = QTime(0, m_pomodoroMinutes, 0);
+    applyPendingDuration();
+    if (m_journal) m_journal->reset();
+    m_engine->setDuration(qint64(m_pomodoroMinutes) * 60 * 1000);
     updateDisplay();
     m_startButton->setEnabled(true);
     m_pauseButton->setEnabled(false);
@@ -525,118 +1051,86 @@ void Antiprocrastinator::resetTimer()
 
 void Antiprocrastinator::updateDisplay()
 {
-    if (m_isRunning) {
-        m_remainingTime = m_remainingTime.addSecs(-1);
-        // Если время истекло, то фиксируем завершение сессии
-        if (m_remainingTime <= QTime(0, 0, 0)) {
-            timerFinished();
-            return;
-        }
-    }
-
-    // Форматируем как MM:SS с ведущими нулями
-    QString timeText = QString("%1:%2")
-                           .arg(m_remainingTime.minute(), 2, 10, QChar('0'))
-                           .arg(m_remainingTime.second(), 2, 10, QChar('0'));
+    // Оставшееся время вычисляется движком от дедлайна, а не уменьшается на тик.
+    // Табло само решает, какие цифры перерисовать; строка и перекладка не нужны
+    m_timeDisplay->setRemainingSeconds(m_engine->remainingSeconds());
 
-    m_timeLabel->setText(timeText);
+    // Контрольная точка — один write в журнал, сам журнал пишет её не чаще раза в 15 с
+    if (m_journal && m_engine->isRunning()) {
+        m_journal->checkpoint(m_engine->elapsedMs());
+    }
 }
 
 void Antiprocrastinator::timerFinished()
 {
-    m_timer->stop();
-    m_isRunning = false;
-
-    if (m_db.isOpen()) {
-        // Записываем сессию в бд в рамках транзакции
-        m_db.transaction();
-
-        QSqlQuery query(m_db);
-        query.prepare("INSERT INTO sessions (duration_minutes) VALUES (:duration)");
-        query.bindValue(":duration", m_pomodoroMinutes);
-        if (!query.exec()) {
-            m_db.rollback();
-            QMessageBox::warning(this, "Ошибка", "Не удалось сохранить сессию. Прогресс может быть потерян.");
-            return;
-        }
-
-        m_sessionsCompleted++;
-        m_sessionCounterLabel->setText(QString("Сессий завершено: %1").arg(m_sessionsCompleted));
-
-        // Открываем следующую цитату, если в коллекции ещё есть закрытые
-        if (m_unlockedCount < m_allQuotes.size()) {
-            m_quotesWithStatus[m_unlockedCount].second = true;
-            m_unlockedCount++;
-        }
-
-        if (!m_db.commit()) {
-            QMessageBox::warning(this, "Ошибка", "Не удалось сохранить прогресс. Попробуйте ещё раз.");
-            return;
-        }
-
-        qDebug() << "Сессия сохранена, открыта цитата #" << m_unlockedCount;
-    } else {
-        // Если бд недоступна, то обновляем только оперативное состояние
-        m_sessionsCompleted++;
-        m_sessionCounterLabel->setText(QString("Сессий завершено: %1").arg(m_sessionsCompleted));
-        if (m_unlockedCount < m_allQuotes.size()) {
-            m_quotesWithStatus[m_unlockedCount].second = true;
-            m_unlockedCount++;
-        }
-    }
+    Trace::Span span("завершение сессии");
+    // Итог сессии показывается в окне, даже если отсчёт шёл из трея
+    if (m_trayIcon && m_trayIcon->isVisible()) restoreFromTray();
+    // Завершение сразу сбрасывается в журнал: если процесс упадёт до записи
+    // в sessions, то сессия будет дописана при следующем запуске
+    const qint64 journalKey = m_journal ? m_journal->finish(m_engine->durationMs()) : 0;
+    commitSession(m_pomodoroMinutes, journalKey);
 
     showMotivationalQuote();
 
-    // Сбрасываем таймер на следующий круг
-    m_remainingTime = QTime(0, m_pomodoroMinutes, 0);
+    // Сбрасываем таймер на следующий круг, с длительностью из .env, если она менялась
+    applyPendingDuration();
+    m_engine->setDuration(qint64(m_pomodoroMinutes) * 60 * 1000);
     updateDisplay();
     m_startButton->setEnabled(true);
     m_pauseButton->setEnabled(false);
     m_startButton->setText("▶️ Новый цикл");
     m_durationSpinBox->setEnabled(true);
 
+    // Конец сессии — естественный момент сбросить накопленные настройки на диск
     saveProgress();
+    m_settings->flush();
+}
+
+void Antiprocrastinator::onSessionRecorded(const QString &profile, int sessionId, qint64 journalKey)
+{
+    qDebug() << "Сессия #" << sessionId << "профиля" << profile << "сохранена, открыто цитат:" << m_quotes.unlockedCount();
+    // Сессия уже в sessions: журналу её профиля больше хранить её незачем
+    SessionJournal *journal = m_journals.value(profile);
+    if (journal && journalKey != 0) journal->commit(journalKey);
+}
+
+void Antiprocrastinator::onWriteFailed(int commandType, const QString &error)
+{
+    Q_UNUSED(error);
+    // О несохранённых настройках не тревожим: они будут записаны повторно при следующем изменении
+    if (commandType == WriteCommand::RecordSession) {
+        QMessageBox::warning(this, "Ошибка", "Не удалось сохранить сессию. Прогресс может быть потерян.");
+    }
+}
+
+void Antiprocrastinator::onCountersRepaired(const QString &profile, int sessionCount)
+{
+    // Сверка базы другого профиля на окно не влияет
+    if (profile != m_profile) return;
+    // Фоновая сверка нашла расхождение: показываем уже исправленное значение
+    m_sessionsCompleted = sessionCount;
+    m_sessionCounterLabel->setText(QString("Сессий завершено: %1").arg(m_sessionsCompleted));
+    // Открытые цитаты хранятся отдельно по идентификаторам, счётчик их не затрагивает
 }
 
 void Antiprocrastinator::showMotivationalQuote()
 {
-    if (m_unlockedCount == 0) return;
-
-    QString quote = m_quotesWithStatus[m_unlockedCount - 1].first;
-
-    // Сначала показываем анимированное вспыхивание, а потом уже через таймеры саму цитату
-    m_quoteLabel->setText("✨ Открыта новая цитата!");
-    m_quoteLabel->setStyleSheet(
-        "QLabel { font-size: 18px; font-weight: bold; color: #e67e22; "
-        "background-color: #fff3cd; border-radius: 8px; padding: 10px; }"
-        );
-
-    QTimer::singleShot(1200, this, [this, quote]() {
-        m_quoteLabel->setText(QString("❝%1❞").arg(quote));
-        // Выбираем стиль подсветки в зависимости от текущей темы
-        QString style = qApp->palette().color(QPalette::Base).lightness() < 128 ?
-                            "QLabel { font-size: 18px; font-weight: bold; font-style: italic; color: #64b5f6; "
-                            "background-color: #2a3b4d; border-radius: 8px; padding: 10px; }" :
-                            "QLabel { font-size: 18px; font-weight: bold; font-style: italic; color: #27ae60; "
-                            "background-color: #e8f5e9; border-radius: 8px; padding: 10px; }";
-        m_quoteLabel->setStyleSheet(style);
-
-        // Убираем выделение и возвращаем обычный вид через 2 с половиной секунды
-        QTimer::singleShot(2500, this, [this]() {
-            QString normalStyle = qApp->palette().color(QPalette::Base).lightness() < 128 ?
-                                      "QLabel { font-size: 16px; font-style: italic; color: #b0bec5; padding: 10px; min-height: 70px; }" :
-                                      "QLabel { font-size: 16px; font-style: italic; color: #7f8c8d; padding: 10px; min-height: 70px; }";
-            m_quoteLabel->setStyleSheet(normalStyle);
-        });
-    });
+    if (m_quotes.lastUnlocked() < 0) return;
+
+    QString quote = m_quotes.text(m_quotes.lastUnlocked());
+
+    // Баннер сам проигрывает вспышку и подсветку, а если предыдущая анимация
+    // ещё идёт, то прерывает её и начинает заново
+    m_quoteBanner->reveal(QString("❝%1❞").arg(quote));
 
     // Показываем модальный диалог с итогами сессии и новой цитатой
     QMessageBox msgBox(this);
     msgBox.setWindowTitle("🏆 Цитата открыта!");
     msgBox.setText(QString("Ты завершил %1 сессий и открыл %2 из %3 цитат!")
                        .arg(m_sessionsCompleted)
-                       .arg(m_unlockedCount)
-                       .arg(m_allQuotes.size()));
+                       .arg(m_quotes.unlockedCount())
+                       .arg(m_quotes.size()));
     msgBox.setInformativeText(QString("❝%1❞").arg(quote));
     msgBox.setIcon(QMessageBox::Information);
     msgBox.setStandardButtons(QMessageBox::Ok);
@@ -646,7 +1140,22 @@ void Antiprocrastinator::showMotivationalQuote()
 
 void Antiprocrastinator::showQuotesCollection()
 {
-    QuotesDialog dialog(m_quotesWithStatus, this);
+    // Пока диалог открыт, перезагрузка файла цитат обновляет его список
+    QuotesDialog dialog(&m_quotes, &m_quoteIndex, this);
+    Trace::instant("коллекция открыта");
+    m_quotesDialog = &dialog;
+    dialog.exec();
+    m_quotesDialog = nullptr;
+}
+
+void Antiprocrastinator::showStatistics()
+{
+    if (!m_repository || !m_repository->isOpen()) {
+        QMessageBox::information(this, "Статистика", "База данных недоступна, статистика не ведётся.");
+        return;
+    }
+    // Сессия, завершённая только что, могла ещё не дойти до бд из потока записи
+    StatsDialog dialog(m_repository, this);
     dialog.exec();
 }
 
@@ -655,16 +1164,27 @@ void Antiprocrastinator::changeTheme(int index)
     Q_UNUSED(index);
     QString theme = m_themeComboBox->currentData().toString();
     applyTheme(theme);
-    // Сразу сохраняем выбор темы, чтобы он пережил перезапуск
+    // Запоминаем выбор темы, чтобы он пережил перезапуск
     saveProgress();
 }
 
+void Antiprocrastinator::applyPendingDuration()
+{
+    if (!m_defaultDurationPending) return;
+    m_defaultDurationPending = false;
+    m_durationSpinBox->setValue(m_defaultDuration);
+}
+
 void Antiprocrastinator::changeDuration(int minutes)
 {
+    // Выбор в поле новее отложенного значения из .env
+    m_defaultDurationPending = false;
     m_pomodoroMinutes = minutes;
-    // Обновляем отображение только если таймер сейчас не идёт
-    if (!m_isRunning) {
-        m_remainingTime = QTime(0, minutes, 0);
+    // Обновляем отображение только если таймер сейчас не идёт.
+    // Сессия на паузе при этом начинается заново, журнал её отменяет
+    if (!m_engine->isRunning()) {
+        if (m_journal) m_journal->reset();
+        m_engine->setDuration(qint64(minutes) * 60 * 1000);
         updateDisplay();
     }
     saveProgress();
@@ -0,0 +1,222 @@
+#include "../headers/connectionpool.h"
+#include "../headers/trace.h"
+#include <QDir>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QThread>
+#include <QDebug>
+#include <vector>
+
+namespace {
+
+const char kProfilesDir[] = "profiles";
+const char kShardSuffix[] = ".db";
+
+} // namespace
+
+ConnectionPool::ConnectionPool(const QString &defaultDbPath, const QString &connectOptions)
+    : m_defaultDbPath(defaultDbPath)
+    , m_connectOptions(connectOptions)
+{
+    // Потоки чтения живут до closeAll, иначе вместе с простаивающим потоком
+    // закрывались бы его соединения и подготовленные запросы
+    m_readers.setExpiryTimeout(-1);
+}
+
+ConnectionPool::~ConnectionPool()
+{
+    closeAll();
+}
+
+bool ConnectionPool::isValidProfileName(const QString &name)
+{
+    if (name.isEmpty() || name.size() > kMaxProfileNameLength) return false;
+    for (const QChar c : name) {
+        if (!c.isLetterOrNumber() && c != '_' && c != '-') return false;
+    }
+    return true;
+}
+
+QString ConnectionPool::shardPath(const QString &profile) const
+{
+    if (profile.isEmpty() || profile == kDefaultProfile) return m_defaultDbPath;
+    return QFileInfo(m_defaultDbPath).dir().filePath(QString("%1/%2%3").arg(kProfilesDir, profile, kShardSuffix));
+}
+
+QStringList ConnectionPool::profiles() const
+{
+    QStringList result;
+    const QDir dir(QFileInfo(m_defaultDbPath).dir().filePath(kProfilesDir));
+    const QStringList files = dir.entryList({QString("*") + kShardSuffix}, QDir::Files, QDir::Name);
+    for (const QString &file : files) {
+        const QString name = file.chopped(int(qstrlen(kShardSuffix)));
+        if (name != kDefaultProfile && isValidProfileName(name)) result.append(name);
+    }
+    result.prepend(kDefaultProfile);
+    return result;
+}
+
+ProgressRepository *ConnectionPool::acquire(const QString &profile, bool *created, QString *error)
+{
+    return openFor(profile, QThread::currentThread(), created, error);
+}
+
+ProgressRepository *ConnectionPool::acquireFor(const QString &profile, QThread *owner, QString *error)
+{
+    return openFor(profile, owner, nullptr, error);
+}
+
+ProgressRepository *ConnectionPool::openFor(const QString &profile, QThread *owner, bool *created, QString *error)
+{
+    if (created) *created = false;
+    const QString name = profile.isEmpty() ? QString(kDefaultProfile) : profile;
+    if (!isValidProfileName(name)) {
+        if (error) *error = QString("Недопустимое имя профиля: %1").arg(name);
+        return nullptr;
+    }
+
+    const Key key(name, owner);
+    QString connectionName;
+    {
+        QMutexLocker locker(&m_mutex);
+        const auto it = m_connections.find(key);
+        if (it != m_connections.end()) {
+            it->second.lastUse = ++m_useClock;
+            return it->second.repository.get();
+        }
+        connectionName = QString("progress_db_%1_%2").arg(name).arg(++m_nextConnectionId);
+    }
+
+    // Открытие идёт без блокировки и не задерживает другие потоки;
+    // соединение для другого потока открывается здесь и передаётся ему готовым
+    Trace::Span span("пул: открытие соединения");
+    const QString path = shardPath(name);
+    QDir().mkpath(QFileInfo(path).path());
+    auto repository = std::make_unique<ProgressRepository>(connectionName);
+    if (!repository->open(path, m_connectOptions)) {
+        if (error) *error = repository->lastError();
+        return nullptr;
+    }
+    // WAL: запись не блокирует чтение, поэтому сводки по профилям идут параллельно с потоком записи
+    if (!repository->exec("PRAGMA journal_mode=WAL")) {
+        qWarning() << "Не удалось включить WAL:" << repository->lastError();
+    }
+    repository->exec("PRAGMA synchronous=NORMAL");
+
+    {
+        QMutexLocker locker(&m_schemaMutex);
+        if (!m_schemaReady.contains(name)) {
+            if (!repository->initSchema()) {
+                if (error) *error = repository->lastError();
+                return nullptr;
+            }
+            m_schemaReady.insert(name);
+        }
+    }
+
+    // Вытесненные соединения закрываются после снятия блокировки
+    std::vector<std::unique_ptr<ProgressRepository>> evicted;
+    QMutexLocker locker(&m_mutex);
+    // Пока соединение открывалось, его мог открыть для того же владельца другой поток.
+    // Своё тогда закрывается здесь же: владельцу оно ещё не передано
+    const auto it = m_connections.find(key);
+    if (it != m_connections.end()) return it->second.repository.get();
+    // Поток может закрыть только свои соединения, поэтому вытеснение — только при
+    // открытии для себя; соединение главного потока окно закрывает само через release
+    if (owner == QThread::currentThread()) evictLeastRecentlyUsed(owner, &evicted);
+    if (owner != QThread::currentThread() && !repository->moveToThread(owner)) {
+        if (error) *error = repository->lastError();
+        return nullptr;
+    }
+    // Соединения потока закрываются в нём же, когда он завершается
+    if (!m_threadWatches.contains(owner)) {
+        m_threadWatches.insert(owner, QObject::connect(owner, &QThread::finished, owner, [this, owner]() {
+            releaseThread(owner);
+        }, Qt::DirectConnection));
+    }
+    ProgressRepository *result = repository.get();
+    m_connections.emplace(key, Entry{std::move(repository), ++m_useClock});
+    Trace::counter("пул: соединений", qint64(m_connections.size()));
+    if (created) *created = true;
+    return result;
+}
+
+void ConnectionPool::releaseThread(QThread *thread)
+{
+    // Соединения вынимаются под блокировкой, а закрываются после неё
+    std::vector<std::unique_ptr<ProgressRepository>> released;
+    {
+        QMutexLocker locker(&m_mutex);
+        for (auto it = m_connections.begin(); it != m_connections.end();) {
+            if (it->first.second == thread) {
+                released.push_back(std::move(it->second.repository));
+                it = m_connections.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        QObject::disconnect(m_threadWatches.take(thread));
+        Trace::counter("пул: соединений", qint64(m_connections.size()));
+    }
+}
+
+void ConnectionPool::releaseCurrentThread()
+{
+    releaseThread(QThread::currentThread());
+}
+
+void ConnectionPool::release(const QString &profile)
+{
+    const QString name = profile.isEmpty() ? QString(kDefaultProfile) : profile;
+    std::unique_ptr<ProgressRepository> released;
+    {
+        QMutexLocker locker(&m_mutex);
+        const auto it = m_connections.find(Key(name, QThread::currentThread()));
+        if (it == m_connections.end()) return;
+        released = std::move(it->second.repository);
+        m_connections.erase(it);
+        Trace::counter("пул: соединений", qint64(m_connections.size()));
+    }
+}
+
+void ConnectionPool::evictLeastRecentlyUsed(QThread *thread, std::vector<std::unique_ptr<ProgressRepository>> *evicted)
+{
+    // Вызывается под m_mutex; освобождает место под ещё одно соединение потока
+    for (;;) {
+        int count = 0;
+        auto oldest = m_connections.end();
+        for (auto it = m_connections.begin(); it != m_connections.end(); ++it) {
+            if (it->first.second != thread) continue;
+            count++;
+            if (oldest == m_connections.end() || it->second.lastUse < oldest->second.lastUse) oldest = it;
+        }
+        if (count < kMaxConnectionsPerThread) return;
+        evicted->push_back(std::move(oldest->second.repository));
+        m_connections.erase(oldest);
+    }
+}
+
+void ConnectionPool::closeAll()
+{
+    // Сначала останавливаются потоки чтения: каждый закрывает свои соединения
+    // сам, по QThread::finished, пока ещё работает
+    m_readers.waitForDone();
+
+    // Остались соединения вызывающего потока и потоков, которые закрыли бы их
+    // сами, но уже не работают с бд (поток записи отпускает свои до остановки)
+    std::map<Key, Entry> released;
+    {
+        QMutexLocker locker(&m_mutex);
+        for (const QMetaObject::Connection &watch : std::as_const(m_threadWatches)) {
+            QObject::disconnect(watch);
+        }
+        m_threadWatches.clear();
+        released.swap(m_connections);
+    }
+}
+
+int ConnectionPool::connectionCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return int(m_connections.size());
+}
@@ -0,0 +1,161 @@
+#include "../headers/countdowndisplay.h"
+#include "../headers/trace.h"
+#include <QEvent>
+#include <QFontMetrics>
+#include <QPaintEvent>
+#include <QPainter>
+#include <QPixmapCache>
+
+namespace {
+
+constexpr int kVerticalMargin = 10;
+constexpr int kColon = 10;
+
+} // namespace
+
+CountdownDisplay::CountdownDisplay(QWidget *parent)
+    : QWidget(parent)
+{
+    // Каждая ячейка закрашивается целиком вместе с фоном, поэтому родителя
+    // под ней перерисовывать не нужно
+    setAttribute(Qt::WA_OpaquePaintEvent);
+    setSizePolicy(QSizePolicy::Preferred, QSizePolicy::Fixed);
+    updateMetrics();
+}
+
+void CountdownDisplay::setRemainingSeconds(int seconds)
+{
+    seconds = qMax(0, seconds);
+    if (seconds == m_seconds) return;
+    m_seconds = seconds;
+
+    const int minutes = qMin(99, seconds / 60);
+    const quint8 glyphs[kCells] = {
+        quint8(minutes / 10), quint8(minutes % 10), kColon, quint8(seconds % 60 / 10), quint8(seconds % 10)
+    };
+    // Обычно за секунду меняется одна последняя цифра
+    for (int cell = 0; cell < kCells; ++cell) {
+        if (glyphs[cell] == m_glyphs[cell]) continue;
+        m_glyphs[cell] = glyphs[cell];
+        update(cellRect(cell));
+    }
+}
+
+QString CountdownDisplay::text() const
+{
+    return QString("%1:%2")
+        .arg(m_seconds / 60, 2, 10, QChar('0'))
+        .arg(m_seconds % 60, 2, 10, QChar('0'));
+}
+
+QSize CountdownDisplay::sizeHint() const
+{
+    return QSize(4 * m_digitWidth + m_colonWidth, m_cellHeight + 2 * kVerticalMargin);
+}
+
+QSize CountdownDisplay::minimumSizeHint() const
+{
+    return sizeHint();
+}
+
+void CountdownDisplay::paintEvent(QPaintEvent *event)
+{
+    Trace::Span span("таймер: отрисовка");
+    if (!ensureAtlas()) return;
+
+    QPainter painter(this);
+    const QRect dirty = event->rect();
+
+    // Поля вокруг цифр закрашиваются только при полной перерисовке
+    const QRect digits = cellRect(0).united(cellRect(kCells - 1));
+    if (!digits.contains(dirty)) {
+        painter.fillRect(dirty, palette().color(QPalette::Window));
+    }
+
+    const qreal ratio = m_atlas.devicePixelRatio();
+    for (int cell = 0; cell < kCells; ++cell) {
+        const QRect target = cellRect(cell);
+        if (!target.intersects(dirty)) continue;
+        const int glyph = m_glyphs[cell];
+        const QRectF source(glyph * m_digitWidth * ratio, 0, target.width() * ratio, m_cellHeight * ratio);
+        painter.drawPixmap(QRectF(target), m_atlas, source);
+    }
+}
+
+void CountdownDisplay::changeEvent(QEvent *event)
+{
+    QWidget::changeEvent(event);
+    switch (event->type()) {
+    case QEvent::FontChange:
+        updateMetrics();
+        updateGeometry();
+        m_atlas = QPixmap();
+        update();
+        break;
+    case QEvent::PaletteChange:
+        m_atlas = QPixmap();
+        update();
+        break;
+    default:
+        break;
+    }
+}
+
+void CountdownDisplay::updateMetrics()
+{
+    // Ячейка цифры шириной в самую широкую цифру: соседние ячейки не сдвигаются
+    const QFontMetrics metrics = fontMetrics();
+    m_digitWidth = 0;
+    for (char digit = '0'; digit <= '9'; ++digit) {
+        m_digitWidth = qMax(m_digitWidth, metrics.horizontalAdvance(QChar(digit)));
+    }
+    m_colonWidth = metrics.horizontalAdvance(QChar(':'));
+    m_cellHeight = metrics.height();
+}
+
+bool CountdownDisplay::ensureAtlas()
+{
+    const qreal ratio = devicePixelRatioF();
+    if (!m_atlas.isNull() && qFuzzyCompare(m_atlas.devicePixelRatio(), ratio)) return true;
+
+    const QColor text = palette().color(QPalette::WindowText);
+    const QColor background = palette().color(QPalette::Window);
+    const QString key = QString("countdown:%1:%2:%3:%4")
+                            .arg(font().key())
+                            .arg(text.rgba())
+                            .arg(background.rgba())
+                            .arg(ratio);
+    if (QPixmapCache::find(key, &m_atlas)) return true;
+
+    Trace::Span span("таймер: атлас цифр");
+    const QSize size(10 * m_digitWidth + m_colonWidth, m_cellHeight);
+    if (size.isEmpty()) return false;
+
+    m_atlas = QPixmap(size * ratio);
+    m_atlas.setDevicePixelRatio(ratio);
+    m_atlas.fill(background);
+
+    QPainter painter(&m_atlas);
+    painter.setRenderHint(QPainter::TextAntialiasing);
+    painter.setFont(font());
+    painter.setPen(text);
+    for (int glyph = 0; glyph <= kColon; ++glyph) {
+        const QRect cell(glyph * m_digitWidth, 0, glyph == kColon ? m_colonWidth : m_digitWidth, m_cellHeight);
+        painter.drawText(cell, Qt::AlignCenter, glyph == kColon ? QString(':') : QString::number(glyph));
+    }
+    painter.end();
+
+    QPixmapCache::insert(key, m_atlas);
+    return true;
+}
+
+QRect CountdownDisplay::cellRect(int cell) const
+{
+    // Табло по центру виджета, ячейки — минуты, двоеточие, секунды
+    const int left = (width() - (4 * m_digitWidth + m_colonWidth)) / 2;
+    const int top = (height() - m_cellHeight) / 2;
+    int x = left + cell * m_digitWidth;
+    if (cell > 2) x += m_colonWidth - m_digitWidth;
+    const int cellWidth = cell == 2 ? m_colonWidth : m_digitWidth;
+    return QRect(x, top, cellWidth, m_cellHeight);
+}
@@ -0,0 +1,233 @@
+#include "../headers/envconfig.h"
+#include <QCoreApplication>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QStandardPaths>
+#include <cstring>
+
+namespace {
+
+void addError(QList<ConfigError> *errors, int line, const QString &message)
+{
+    if (errors) errors->append({line, message});
+}
+
+// Значение в кавычках берётся как есть, у значения без кавычек
+// отрезается комментарий после пробела и '#'
+QByteArrayView unquote(QByteArrayView value)
+{
+    if (value.size() >= 2) {
+        const char first = value.front();
+        if ((first == '"' || first == '\'') && value.back() == first) {
+            return value.sliced(1, value.size() - 2);
+        }
+    }
+    for (qsizetype i = 1; i < value.size(); ++i) {
+        if (value.at(i) == '#' && (value.at(i - 1) == ' ' || value.at(i - 1) == '\t')) {
+            return value.first(i).trimmed();
+        }
+    }
+    return value;
+}
+
+bool isChoice(const char *choices, QByteArrayView value)
+{
+    QByteArrayView rest(choices);
+    while (!rest.isEmpty()) {
+        const qsizetype bar = rest.indexOf('|');
+        const QByteArrayView choice = bar < 0 ? rest : rest.first(bar);
+        if (choice == value) return true;
+        rest = bar < 0 ? QByteArrayView() : rest.sliced(bar + 1);
+    }
+    return false;
+}
+
+// Проверяет значение по схеме и записывает его в config
+bool assign(EnvConfig &config, const ConfigKey &key, QByteArrayView value, QString *error)
+{
+    switch (key.type) {
+    case ConfigKey::Integer: {
+        bool ok = false;
+        const int number = value.toInt(&ok);
+        if (!ok) {
+            *error = QString("ожидается целое число, получено «%1»").arg(QString::fromUtf8(value));
+            return false;
+        }
+        if (number < key.minimum || number > key.maximum) {
+            *error = QString("значение %1 вне диапазона %2..%3").arg(number).arg(key.minimum).arg(key.maximum);
+            return false;
+        }
+        config.*key.number = number;
+        return true;
+    }
+    case ConfigKey::Choice:
+        if (!isChoice(key.choices, value)) {
+            *error = QString("допустимые значения: %1, получено «%2»")
+                         .arg(QString::fromLatin1(key.choices).replace('|', ", "), QString::fromUtf8(value));
+            return false;
+        }
+        config.*key.text = QString::fromUtf8(value);
+        return true;
+    case ConfigKey::Text:
+    case ConfigKey::Path:
+        if (value.isEmpty()) {
+            *error = "пустое значение";
+            return false;
+        }
+        // fromNativeSeparators заменяет обратные слеши (Windows) на прямые,
+        // чтобы пути из .env корректно работали на macOS и Linux
+        config.*key.text = key.type == ConfigKey::Path ? QDir::fromNativeSeparators(QString::fromUtf8(value))
+                                                       : QString::fromUtf8(value);
+        return true;
+    }
+    return false;
+}
+
+} // namespace
+
+const QVector<ConfigKey> &envConfigSchema()
+{
+    static const QVector<ConfigKey> schema = {
+        {"QUOTES_FILE_PATH", ConfigKey::Path,    &EnvConfig::quotesFilePath, nullptr, 0, 0, nullptr, true},
+        {"DEFAULT_DURATION", ConfigKey::Integer, nullptr, &EnvConfig::defaultDuration, 5, 60, nullptr, true},
+        {"DEFAULT_THEME",    ConfigKey::Choice,  &EnvConfig::defaultTheme, nullptr, 0, 0, "light|dark", true},
+        {"DB_PATH",          ConfigKey::Path,    &EnvConfig::dbPath, nullptr, 0, 0, nullptr, false},
+        {"PROFILE",          ConfigKey::Text,    &EnvConfig::profile, nullptr, 0, 0, nullptr, false},
+        {"TRACE_PATH",       ConfigKey::Path,    &EnvConfig::tracePath, nullptr, 0, 0, nullptr, false},
+        {"TRACE_BUFFER_EVENTS", ConfigKey::Integer, nullptr, &EnvConfig::traceBufferEvents, 1024, 4194304, nullptr, false},
+    };
+    return schema;
+}
+
+bool isHotReloadConfigKey(const QString &name)
+{
+    for (const ConfigKey &key : envConfigSchema()) {
+        if (name == QLatin1String(key.name)) return key.hotReload;
+    }
+    return false;
+}
+
+EnvConfig parseEnvConfig(const QByteArray &data, QList<ConfigError> *errors)
+{
+    const QVector<ConfigKey> &schema = envConfigSchema();
+    EnvConfig config;
+
+    // Строки не копируются: ключ и значение — это срезы исходного буфера,
+    // а в QString переводятся только принятые значения
+    const char *pos = data.constData();
+    const char *end = pos + data.size();
+    if (data.startsWith("\xEF\xBB\xBF")) pos += 3;
+
+    int lineNumber = 0;
+    while (pos < end) {
+        const char *eol = static_cast<const char *>(std::memchr(pos, '\n', size_t(end - pos)));
+        if (!eol) eol = end;
+        const QByteArrayView line = QByteArrayView(pos, eol).trimmed();
+        pos = eol == end ? end : eol + 1;
+        ++lineNumber;
+
+        // Пропускаем пустые строки и комментарии
+        if (line.isEmpty() || line.front() == '#') continue;
+
+        const qsizetype eq = line.indexOf('=');
+        if (eq <= 0) {
+            addError(errors, lineNumber, "ожидается строка вида КЛЮЧ=ЗНАЧЕНИЕ");
+            continue;
+        }
+        const QByteArrayView name = line.first(eq).trimmed();
+        const QByteArrayView value = unquote(line.sliced(eq + 1).trimmed());
+
+        const ConfigKey *key = nullptr;
+        for (const ConfigKey &candidate : schema) {
+            if (name == QByteArrayView(candidate.name)) {
+                key = &candidate;
+                break;
+            }
+        }
+        if (!key) {
+            addError(errors, lineNumber, QString("неизвестный ключ %1").arg(QString::fromUtf8(name)));
+            continue;
+        }
+
+        QString error;
+        if (!assign(config, *key, value, &error)) {
+            addError(errors, lineNumber, QString("%1: %2").arg(QString::fromLatin1(key->name), error));
+        }
+    }
+    return config;
+}
+
+QStringList changedConfigKeys(const EnvConfig &before, const EnvConfig &after)
+{
+    QStringList keys;
+    for (const ConfigKey &key : envConfigSchema()) {
+        const bool changed = key.type == ConfigKey::Integer ? before.*key.number != after.*key.number
+                                                            : before.*key.text != after.*key.text;
+        if (changed) keys.append(QString::fromLatin1(key.name));
+    }
+    return keys;
+}
+
+QString findEnvFile()
+{
+    // Ищем .env-файл рядом с исполняемым файлом или в текущей директории
+    const QStringList searchPaths = {
+        QCoreApplication::applicationDirPath(),
+        QCoreApplication::applicationDirPath() + "/..",
+        QDir::currentPath()
+    };
+
+    for (const QString &path : searchPaths) {
+        const QString candidate = QDir::cleanPath(path + "/.env");
+        if (QFile::exists(candidate)) {
+            return candidate;
+        }
+    }
+    return QString();
+}
+
+EnvConfig loadEnvConfig(QList<ConfigError> *errors)
+{
+    return loadEnvConfig(findEnvFile(), errors);
+}
+
+EnvConfig loadEnvConfig(const QString &envFile, QList<ConfigError> *errors)
+{
+    // Значения по умолчанию используются, если .env не найден или не содержит нужного ключа
+    EnvConfig config;
+    if (!envFile.isEmpty()) {
+        QFile file(envFile);
+        if (file.open(QIODevice::ReadOnly)) {
+            QList<ConfigError> fileErrors;
+            config = parseEnvConfig(file.readAll(), &fileErrors);
+            for (const ConfigError &error : std::as_const(fileErrors)) {
+                qWarning().noquote() << QString("%1:%2: %3").arg(envFile).arg(error.line).arg(error.message);
+            }
+            if (errors) *errors = fileErrors;
+            config.filePath = envFile;
+        } else {
+            qWarning() << "Не удалось прочитать" << envFile << file.errorString();
+        }
+    }
+
+    if (config.dbPath.isEmpty()) {
+        config.dbPath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation)
+                        + "/antiprocrastinator/progress.db";
+    } else if (QFileInfo(config.dbPath).isRelative()) {
+        config.dbPath = QDir::home().filePath(config.dbPath);
+    }
+
+    if (!config.tracePath.isEmpty() && QFileInfo(config.tracePath).isRelative()) {
+        config.tracePath = QDir::home().filePath(config.tracePath);
+    }
+
+    // Создаём директорию для бд заранее, чтобы SQLite не упал при открытии
+    QFileInfo dbFileInfo(config.dbPath);
+    if (!dbFileInfo.dir().exists()) {
+        dbFileInfo.dir().mkpath(".");
+    }
+
+    return config;
+}
@@ -0,0 +1,26 @@
+#include "../headers/envconfigwatcher.h"
+#include "../headers/filechangewatcher.h"
+#include <QDebug>
+
+EnvConfigWatcher::EnvConfigWatcher(const EnvConfig &initial, QObject *parent)
+    : QObject(parent)
+    , m_config(initial)
+    , m_watcher(new FileChangeWatcher(this))
+{
+    connect(m_watcher, &FileChangeWatcher::changed, this, &EnvConfigWatcher::reload);
+    m_watcher->setFilePath(m_config.filePath);
+}
+
+void EnvConfigWatcher::reload()
+{
+    // Файл мог оказаться недоступен для чтения: тогда оставляем прежние значения
+    const EnvConfig updated = loadEnvConfig(m_config.filePath, nullptr);
+    if (updated.filePath.isEmpty()) return;
+
+    const QStringList changed = changedConfigKeys(m_config, updated);
+    if (changed.isEmpty()) return;
+
+    qDebug() << ".env изменён, новые значения ключей:" << changed;
+    m_config = updated;
+    emit reloaded(m_config, changed);
+}
@@ -0,0 +1,63 @@
+#include "../headers/filechangewatcher.h"
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QTimer>
+
+FileChangeWatcher::FileChangeWatcher(QObject *parent)
+    : QObject(parent)
+    , m_watcher(new QFileSystemWatcher(this))
+    , m_settleTimer(new QTimer(this))
+{
+    m_settleTimer->setSingleShot(true);
+    m_settleTimer->setInterval(kSettleMs);
+    connect(m_settleTimer, &QTimer::timeout, this, &FileChangeWatcher::check);
+
+    connect(m_watcher, &QFileSystemWatcher::fileChanged, this, &FileChangeWatcher::scheduleCheck);
+    connect(m_watcher, &QFileSystemWatcher::directoryChanged, this, &FileChangeWatcher::scheduleCheck);
+}
+
+void FileChangeWatcher::setFilePath(const QString &path)
+{
+    m_settleTimer->stop();
+    const QStringList watched = m_watcher->files() + m_watcher->directories();
+    if (!watched.isEmpty()) {
+        m_watcher->removePaths(watched);
+    }
+
+    m_path = path;
+    m_lastModified = QDateTime();
+    m_lastSize = -1;
+    if (m_path.isEmpty()) return;
+
+    const QFileInfo info(m_path);
+    m_lastModified = info.lastModified();
+    m_lastSize = info.exists() ? info.size() : -1;
+    m_watcher->addPath(info.absolutePath());
+    watch();
+}
+
+void FileChangeWatcher::scheduleCheck()
+{
+    m_settleTimer->start();
+}
+
+void FileChangeWatcher::watch()
+{
+    if (!m_watcher->files().contains(m_path) && QFileInfo::exists(m_path)) {
+        m_watcher->addPath(m_path);
+    }
+}
+
+void FileChangeWatcher::check()
+{
+    watch();
+
+    // Файл мог быть удалён или ещё не дописан: ждём следующего изменения
+    const QFileInfo info(m_path);
+    if (!info.exists()) return;
+    if (info.lastModified() == m_lastModified && info.size() == m_lastSize) return;
+
+    m_lastModified = info.lastModified();
+    m_lastSize = info.size();
+    emit changed();
+}
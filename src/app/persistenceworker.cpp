@@ -0,0 +1,168 @@
+#include "../headers/persistenceworker.h"
+#include "../headers/connectionpool.h"
+#include "../headers/trace.h"
+#include <QThread>
+#include <QMutexLocker>
+#include <QDebug>
+
+namespace {
+
+// Имена транзакций в трассировке, в порядке WriteCommand::Type
+const char *const kCommandSpans[] = {
+    "бд: запись сессии",
+    "бд: запись настроек",
+    "бд: перенос открытий"
+};
+
+} // namespace
+
+PersistenceWorker::PersistenceWorker(ConnectionPool *pool, const QString &profile, QObject *parent)
+    : QObject(parent)
+    , m_pool(pool)
+    , m_profile(profile.isEmpty() ? QString(ConnectionPool::kDefaultProfile) : profile)
+    , m_thread(new QThread(this))
+    , m_context(new QObject)
+{
+    m_thread->setObjectName("PersistenceWorker");
+    m_context->moveToThread(m_thread);
+    m_thread->start();
+    openProfile(m_profile);
+}
+
+PersistenceWorker::~PersistenceWorker()
+{
+    // Блокирующий вызов гарантирует, что всё поставленное в очередь будет записано
+    // до закрытия соединений и остановки потока
+    QMetaObject::invokeMethod(m_context, [this]() {
+        drain();
+        m_pool->releaseCurrentThread();
+    }, Qt::BlockingQueuedConnection);
+
+    m_thread->quit();
+    m_thread->wait();
+    delete m_context;
+}
+
+void PersistenceWorker::enqueue(const WriteCommand &command)
+{
+    bool wasEmpty;
+    {
+        QMutexLocker locker(&m_mutex);
+        wasEmpty = m_queue.isEmpty();
+        m_queue.enqueue(command);
+    }
+
+    // Один вызов drain забирает все команды, накопившиеся к моменту его выполнения
+    if (wasEmpty) {
+        QMetaObject::invokeMethod(m_context, [this]() { drain(); }, Qt::QueuedConnection);
+    }
+}
+
+void PersistenceWorker::openProfile(const QString &profile)
+{
+    // Соединение с SQLite можно использовать только из создавшего его потока
+    QMetaObject::invokeMethod(m_context, [this, profile]() { connection(profile); }, Qt::QueuedConnection);
+}
+
+ProgressRepository *PersistenceWorker::connection(const QString &profile, QString *error)
+{
+    const QString name = profile.isEmpty() ? m_profile : profile;
+    bool created = false;
+    QString openError;
+    ProgressRepository *repository = m_pool->acquire(name, &created, &openError);
+    if (!repository) {
+        qWarning() << "Поток записи не смог открыть БД профиля" << name << ":" << openError;
+        if (error) *error = openError;
+        return nullptr;
+    }
+
+    // Полная сверка счётчика и свёрток требует проходов по sessions, поэтому выполняется здесь,
+    // в фоне, и только при первом открытии базы профиля этим потоком
+    bool repaired = false;
+    if (created && !repository->verifyCounters(&repaired)) {
+        qWarning() << "Не удалось сверить счётчики:" << repository->lastError();
+    } else if (repaired) {
+        emit countersRepaired(name, repository->sessionCount());
+    }
+    return repository;
+}
+
+void PersistenceWorker::drain()
+{
+    QQueue<WriteCommand> pending;
+    {
+        QMutexLocker locker(&m_mutex);
+        pending.swap(m_queue);
+    }
+    Trace::counter("очередь записи", pending.size());
+
+    while (!pending.isEmpty()) {
+        const WriteCommand command = pending.dequeue();
+        int sessionId = -1;
+        QString error;
+
+        if (!execute(command, &sessionId, &error)) {
+            qWarning() << "Ошибка записи в БД:" << error;
+            emit writeFailed(command.type, error);
+        } else if (command.type == WriteCommand::RecordSession) {
+            emit sessionRecorded(command.profile.isEmpty() ? m_profile : command.profile,
+                                 sessionId, command.journalKey);
+        } else if (command.type == WriteCommand::SaveSettings) {
+            emit settingsSaved();
+        }
+    }
+}
+
+bool PersistenceWorker::execute(const WriteCommand &command, int *sessionId, QString *error)
+{
+    ProgressRepository *repository = connection(command.profile, error);
+    if (!repository) {
+        if (error->isEmpty()) *error = "База данных недоступна";
+        return false;
+    }
+
+    // Каждая команда выполняется атомарно в своей транзакции
+    Trace::Span span(kCommandSpans[command.type]);
+    if (!repository->transaction()) {
+        *error = repository->lastError();
+        return false;
+    }
+
+    bool ok = true;
+    switch (command.type) {
+    case WriteCommand::RecordSession:
+        *sessionId = repository->recordSession(command.durationMinutes);
+        ok = *sessionId >= 0;
+        // Сессия и открытая ею цитата записываются вместе или не записываются вовсе
+        if (ok && command.unlocksQuote) {
+            ok = repository->unlockQuoteForSession(*sessionId, command.quoteId);
+        }
+        // Ключ журнала фиксируется той же транзакцией: после падения до сжатия
+        // журнала по нему видно, что сессия уже в sessions и повторять её не нужно
+        if (ok && command.journalKey != 0) {
+            ok = repository->setCounter("journal_committed", command.journalKey);
+        }
+        break;
+
+    case WriteCommand::MigrateUnlocks:
+        ok = repository->migrateLegacyUnlocks(command.quoteIds);
+        break;
+
+    case WriteCommand::SaveSettings:
+        for (const auto &setting : command.settings) {
+            if (!repository->setSetting(setting.first, setting.second)) {
+                ok = false;
+                break;
+            }
+        }
+        break;
+    }
+
+    if (!ok || !repository->commit()) {
+        *error = repository->lastError();
+        repository->rollback();
+        return false;
+    }
+
+    return true;
+}
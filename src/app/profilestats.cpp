@@ -0,0 +1,60 @@
+#include "../headers/profilestats.h"
+#include "../headers/connectionpool.h"
+#include "../headers/trace.h"
+#include <QtConcurrent/QtConcurrentMap>
+#include <functional>
+
+namespace {
+
+void add(StatsRow &sum, const StatsRow &row)
+{
+    sum.sessions += row.sessions;
+    sum.minutes += row.minutes;
+}
+
+} // namespace
+
+ProfileSummary ProfileStats::summarize(ConnectionPool *pool, const QString &profile, const QDate &today)
+{
+    Trace::Span span("сводка: профиль");
+    ProfileSummary summary;
+    summary.profile = profile;
+
+    ProgressRepository *repository = pool->acquire(profile, nullptr, &summary.error);
+    if (!repository) return summary;
+
+    // Те же свёртки, что и в окне статистики: стоимость не зависит от длины истории
+    const QDate weekStart = today.addDays(1 - today.dayOfWeek());
+    summary.sessions = repository->sessionCount();
+    summary.today = repository->statsTotal(today, today);
+    summary.week = repository->statsTotal(weekStart, today);
+    summary.total = repository->statsTotal(QDate(1970, 1, 1), today);
+    summary.streaks = repository->streaks(today);
+    summary.ok = true;
+    return summary;
+}
+
+QFuture<ProfileSummary> ProfileStats::collect(ConnectionPool *pool, const QStringList &profiles, const QDate &today)
+{
+    const std::function<ProfileSummary(const QString &)> summarizeOne = [pool, today](const QString &profile) {
+        return summarize(pool, profile, today);
+    };
+    // Свой пул потоков: closeAll дожидается его, и каждый поток закрывает свои соединения сам
+    return QtConcurrent::mapped(pool->readers(), profiles, summarizeOne);
+}
+
+ProfileSummary ProfileStats::combine(const QList<ProfileSummary> &summaries)
+{
+    ProfileSummary sum;
+    sum.ok = true;
+    for (const ProfileSummary &summary : summaries) {
+        if (!summary.ok) continue;
+        sum.sessions += summary.sessions;
+        add(sum.today, summary.today);
+        add(sum.week, summary.week);
+        add(sum.total, summary.total);
+        sum.streaks.current = qMax(sum.streaks.current, summary.streaks.current);
+        sum.streaks.longest = qMax(sum.streaks.longest, summary.streaks.longest);
+    }
+    return sum;
+}
@@ -0,0 +1,633 @@
+#include "../headers/progressrepository.h"
+#include "../headers/trace.h"
+#include <QSqlError>
+#include <QVariant>
+#include <QDebug>
+#include <utility>
+
+namespace {
+
+// Тексты запросов в порядке ProgressRepository::Statement
+const char *const kStatementSql[] = {
+    "INSERT INTO sessions (duration_minutes) VALUES (?)",
+    "SELECT value FROM settings WHERE key = ?",
+    "INSERT OR REPLACE INTO settings (key, value) VALUES (?, ?)",
+    "INSERT OR IGNORE INTO settings (key, value) VALUES (?, ?)",
+    "SELECT value FROM counters WHERE name = ?",
+    "SELECT day, sessions, minutes FROM stats_daily WHERE day BETWEEN ? AND ? ORDER BY day DESC",
+    "SELECT week, sessions, minutes FROM stats_weekly WHERE week BETWEEN ? AND ? ORDER BY week DESC",
+    "SELECT month, sessions, minutes FROM stats_monthly WHERE month BETWEEN ? AND ? ORDER BY month DESC",
+    "SELECT COALESCE(SUM(sessions), 0), COALESCE(SUM(minutes), 0) FROM stats_daily WHERE day BETWEEN ? AND ?",
+    "SELECT day FROM stats_daily WHERE sessions > 0 ORDER BY day DESC",
+    "INSERT OR IGNORE INTO unlocked_quotes (quote_id, session_id) VALUES (?, ?)",
+    "SELECT quote_id FROM unlocked_quotes ORDER BY session_id",
+    "INSERT OR REPLACE INTO counters (name, value) VALUES (?, ?)"
+};
+
+// Начало периода для момента сессии. start_time хранится в UTC, а статистика
+// считается по местным дням; неделя начинается с понедельника
+const char kDayExpr[] = "date(%1, 'localtime')";
+const char kWeekExpr[] = "date(%1, 'localtime', 'weekday 0', '-6 days')";
+const char kMonthExpr[] = "date(%1, 'localtime', 'start of month')";
+
+struct RollupTable {
+    const char *table;
+    const char *column;
+    const char *expr;
+};
+
+const RollupTable kRollups[] = {
+    {"stats_daily", "day", kDayExpr},
+    {"stats_weekly", "week", kWeekExpr},
+    {"stats_monthly", "month", kMonthExpr}
+};
+
+} // namespace
+
+ProgressRepository::ProgressRepository(const QString &connectionName)
+    : m_connectionName(connectionName)
+{
+}
+
+ProgressRepository::~ProgressRepository()
+{
+    close();
+}
+
+bool ProgressRepository::open(const QString &dbPath, const QString &connectOptions)
+{
+    close();
+
+    // Удаляем старое соединение, если оно осталось от предыдущего запуска
+    if (QSqlDatabase::contains(m_connectionName)) {
+        QSqlDatabase::removeDatabase(m_connectionName);
+    }
+
+    m_db = QSqlDatabase::addDatabase("QSQLITE", m_connectionName);
+    m_db.setDatabaseName(dbPath);
+    if (!connectOptions.isEmpty()) {
+        m_db.setConnectOptions(connectOptions);
+    }
+
+    if (!m_db.open()) {
+        m_lastError = m_db.lastError().text();
+        return false;
+    }
+    return true;
+}
+
+void ProgressRepository::releaseStatements()
+{
+    for (int i = 0; i < StatementCount; ++i) {
+        m_statements[i] = QSqlQuery();
+        m_prepared[i] = false;
+    }
+}
+
+void ProgressRepository::close()
+{
+    // Подготовленные запросы держат ссылку на драйвер, их нужно отпустить до закрытия
+    releaseStatements();
+
+    if (m_db.isValid()) {
+        if (m_db.isOpen()) {
+            m_db.close();
+        }
+        m_db = QSqlDatabase();
+        QSqlDatabase::removeDatabase(m_connectionName);
+    }
+}
+
+bool ProgressRepository::moveToThread(QThread *thread)
+{
+    // QSqlDatabase не переносится, пока к нему привязан хоть один QSqlQuery
+    releaseStatements();
+    if (!m_db.moveToThread(thread)) {
+        m_lastError = "Не удалось передать соединение другому потоку";
+        return false;
+    }
+    return true;
+}
+
+bool ProgressRepository::initSchema()
+{
+    Trace::Span span("бд: схема");
+    // Таблица sessions хранит каждую завершённую помодоро-сессию
+    if (!exec(R"(
+        CREATE TABLE IF NOT EXISTS sessions (
+            id INTEGER PRIMARY KEY AUTOINCREMENT,
+            start_time DATETIME DEFAULT CURRENT_TIMESTAMP,
+            duration_minutes INTEGER NOT NULL
+        )
+    )")) {
+        qWarning() << "Ошибка создания таблицы sessions:" << m_lastError;
+        return false;
+    }
+
+    // Таблица settings хранит пользовательские предпочтения
+    if (!exec(R"(
+        CREATE TABLE IF NOT EXISTS settings (
+            key TEXT PRIMARY KEY,
+            value TEXT NOT NULL
+        )
+    )")) {
+        qWarning() << "Ошибка создания таблицы settings:" << m_lastError;
+        return false;
+    }
+
+    // Таблица counters хранит готовые агрегаты, чтобы не считать COUNT(*) по всей sessions.
+    // Триггеры обновляют счётчик в той же транзакции, что и вставку или удаление сессии,
+    // поэтому он не может разойтись с таблицей из-за сбоя посреди записи
+    if (!transaction()) return false;
+    const bool ok = exec(R"(
+        CREATE TABLE IF NOT EXISTS counters (
+            name TEXT PRIMARY KEY,
+            value INTEGER NOT NULL
+        )
+    )") && exec(R"(
+        CREATE TRIGGER IF NOT EXISTS sessions_counter_insert AFTER INSERT ON sessions
+        BEGIN
+            UPDATE counters SET value = value + 1 WHERE name = 'sessions';
+        END
+    )") && exec(R"(
+        CREATE TRIGGER IF NOT EXISTS sessions_counter_delete AFTER DELETE ON sessions
+        BEGIN
+            UPDATE counters SET value = value - 1 WHERE name = 'sessions';
+        END
+    )") && exec(R"(
+        INSERT INTO counters (name, value)
+        SELECT 'sessions', (SELECT COUNT(*) FROM sessions)
+        WHERE NOT EXISTS (SELECT 1 FROM counters WHERE name = 'sessions')
+    )");
+    // Полный подсчёт выше выполняется только один раз, при первом создании счётчика
+    if (!ok || !commit()) {
+        qWarning() << "Ошибка создания таблицы counters:" << m_lastError;
+        rollback();
+        return false;
+    }
+
+    if (!transaction()) return false;
+    if (!initStatsSchema() || !commit()) {
+        qWarning() << "Ошибка создания таблиц статистики:" << m_lastError;
+        rollback();
+        return false;
+    }
+
+    if (!transaction()) return false;
+    if (!initUnlocksSchema() || !commit()) {
+        qWarning() << "Ошибка создания таблицы unlocked_quotes:" << m_lastError;
+        rollback();
+        return false;
+    }
+
+    return true;
+}
+
+bool ProgressRepository::initUnlocksSchema()
+{
+    // Открытая цитата хранится по идентификатору содержимого, а не по позиции в файле,
+    // поэтому переживает правку, перестановку и дописывание коллекции.
+    // quote_id — 64-битный хеш, записанный как знаковое целое SQLite; PRIMARY KEY
+    // делает его ключом самой таблицы, отдельный индекс не нужен
+    const bool ok = exec(R"(
+        CREATE TABLE IF NOT EXISTS unlocked_quotes (
+            quote_id INTEGER PRIMARY KEY,
+            session_id INTEGER NOT NULL,
+            unlocked_at DATETIME DEFAULT CURRENT_TIMESTAMP
+        )
+    )") && exec(R"(
+        CREATE INDEX IF NOT EXISTS unlocked_quotes_session ON unlocked_quotes (session_id)
+    )") && exec(R"(
+        CREATE TRIGGER IF NOT EXISTS unlocked_quotes_delete AFTER DELETE ON sessions
+        BEGIN
+            DELETE FROM unlocked_quotes WHERE session_id = OLD.id;
+        END
+    )");
+    if (!ok) return false;
+
+    // В новой базе переносить нечего: отмечаем перенос выполненным сразу
+    return exec(R"(
+        INSERT INTO counters (name, value)
+        SELECT 'unlocks_migrated', 1
+        WHERE NOT EXISTS (SELECT 1 FROM counters WHERE name = 'unlocks_migrated')
+          AND NOT EXISTS (SELECT 1 FROM sessions)
+    )");
+}
+
+bool ProgressRepository::initStatsSchema()
+{
+    // Свёртки по дням, неделям и месяцам. Триггеры обновляют их в той же транзакции,
+    // что и вставку сессии, поэтому запрос за любой диапазон читает несколько сотен
+    // строк свёрток, а не агрегирует всю историю sessions
+    for (const RollupTable &rollup : kRollups) {
+        const QString table = QString::fromLatin1(rollup.table);
+        const QString column = QString::fromLatin1(rollup.column);
+        const QString newKey = QString::fromLatin1(rollup.expr).arg("NEW.start_time");
+        const QString oldKey = QString::fromLatin1(rollup.expr).arg("OLD.start_time");
+
+        const bool ok = exec(QString(R"(
+            CREATE TABLE IF NOT EXISTS %1 (
+                %2 TEXT PRIMARY KEY,
+                sessions INTEGER NOT NULL,
+                minutes INTEGER NOT NULL
+            )
+        )").arg(table, column)) && exec(QString(R"(
+            CREATE TRIGGER IF NOT EXISTS %1_insert AFTER INSERT ON sessions
+            BEGIN
+                INSERT INTO %1 (%2, sessions, minutes)
+                VALUES (%3, 1, NEW.duration_minutes)
+                ON CONFLICT(%2) DO UPDATE SET sessions = sessions + 1,
+                                              minutes = minutes + excluded.minutes;
+            END
+        )").arg(table, column, newKey)) && exec(QString(R"(
+            CREATE TRIGGER IF NOT EXISTS %1_delete AFTER DELETE ON sessions
+            BEGIN
+                UPDATE %1 SET sessions = sessions - 1,
+                              minutes = minutes - OLD.duration_minutes
+                WHERE %2 = %3;
+            END
+        )").arg(table, column, oldKey));
+        if (!ok) return false;
+    }
+
+    // Свёртки появились позже sessions: один раз заполняем их по уже накопленной истории
+    bool backfilled = false;
+    getCounter("stats_backfilled", &backfilled);
+    if (backfilled) return true;
+
+    if (!rebuildRollups()) return false;
+    return exec("INSERT INTO counters (name, value) VALUES ('stats_backfilled', 1)");
+}
+
+bool ProgressRepository::rebuildRollups()
+{
+    for (const RollupTable &rollup : kRollups) {
+        const QString table = QString::fromLatin1(rollup.table);
+        const QString key = QString::fromLatin1(rollup.expr).arg("start_time");
+        if (!exec(QString("DELETE FROM %1").arg(table)) || !exec(QString(R"(
+            INSERT INTO %1 (%2, sessions, minutes)
+            SELECT %3, COUNT(*), SUM(duration_minutes) FROM sessions GROUP BY 1
+        )").arg(table, QString::fromLatin1(rollup.column), key))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ProgressRepository::verifyCounters(bool *repaired)
+{
+    if (repaired) *repaired = false;
+
+    QSqlQuery query(m_db);
+    if (!query.exec("SELECT COUNT(*), COALESCE(SUM(duration_minutes), 0) FROM sessions") || !query.next()) {
+        m_lastError = query.lastError().text();
+        return false;
+    }
+    const qint64 actual = query.value(0).toLongLong();
+    const qint64 actualMinutes = query.value(1).toLongLong();
+    query.finish();
+
+    // Свёртки ведутся теми же триггерами и так же могут разойтись с sessions.
+    // Суммы по каждой из них должны совпасть с итогом таблицы
+    for (const RollupTable &rollup : kRollups) {
+        if (!query.exec(QString("SELECT COALESCE(SUM(sessions), 0), COALESCE(SUM(minutes), 0) FROM %1")
+                            .arg(QString::fromLatin1(rollup.table)))
+            || !query.next()) {
+            m_lastError = query.lastError().text();
+            return false;
+        }
+        const qint64 rolledSessions = query.value(0).toLongLong();
+        const qint64 rolledMinutes = query.value(1).toLongLong();
+        query.finish();
+        if (rolledSessions == actual && rolledMinutes == actualMinutes) continue;
+
+        qWarning() << "Свёртка" << rollup.table << "разошлась с таблицей:" << rolledSessions << "сессий вместо" << actual
+                   << ", пересобираем свёртки";
+        if (!transaction()) return false;
+        if (!rebuildRollups() || !commit()) {
+            rollback();
+            return false;
+        }
+        if (repaired) *repaired = true;
+        break;
+    }
+
+    bool found = false;
+    const qint64 stored = getCounter("sessions", &found);
+    if (found && stored == actual) {
+        return true;
+    }
+
+    // Счётчик разошёлся с таблицей (например, sessions правили вручную) — пересобираем
+    qWarning() << "Счётчик сессий разошёлся с таблицей:" << stored << "вместо" << actual;
+    if (!query.prepare("INSERT OR REPLACE INTO counters (name, value) VALUES ('sessions', ?)")) {
+        m_lastError = query.lastError().text();
+        return false;
+    }
+    query.bindValue(0, actual);
+    if (!query.exec()) {
+        m_lastError = query.lastError().text();
+        return false;
+    }
+    if (repaired) *repaired = true;
+    return true;
+}
+
+void ProgressRepository::seedSettings(const QString &theme, int duration)
+{
+    // INSERT OR IGNORE не трогает значения, которые уже есть в бд
+    QSqlQuery *query = statement(SeedSetting);
+    if (!query) return;
+
+    query->bindValue(0, QStringLiteral("theme"));
+    query->bindValue(1, theme);
+    run(query);
+
+    query->bindValue(0, QStringLiteral("duration"));
+    query->bindValue(1, QString::number(duration));
+    run(query);
+    query->finish();
+}
+
+bool ProgressRepository::exec(const QString &sql)
+{
+    QSqlQuery query(m_db);
+    if (!query.exec(sql)) {
+        m_lastError = query.lastError().text();
+        return false;
+    }
+    return true;
+}
+
+bool ProgressRepository::transaction()
+{
+    if (!m_db.transaction()) {
+        m_lastError = m_db.lastError().text();
+        return false;
+    }
+    return true;
+}
+
+bool ProgressRepository::commit()
+{
+    if (!m_db.commit()) {
+        m_lastError = m_db.lastError().text();
+        return false;
+    }
+    return true;
+}
+
+void ProgressRepository::rollback()
+{
+    m_db.rollback();
+}
+
+int ProgressRepository::recordSession(int durationMinutes)
+{
+    QSqlQuery *query = statement(InsertSession);
+    if (!query) return -1;
+
+    query->bindValue(0, durationMinutes);
+    if (!run(query)) return -1;
+    const int id = query->lastInsertId().toInt();
+    query->finish();
+    return id;
+}
+
+bool ProgressRepository::unlockQuoteForSession(int sessionId, quint64 quoteId)
+{
+    QSqlQuery *query = statement(InsertUnlockedQuote);
+    if (!query) return false;
+
+    query->bindValue(0, qint64(quoteId));
+    query->bindValue(1, sessionId);
+    const bool ok = run(query);
+    query->finish();
+    return ok;
+}
+
+QVector<quint64> ProgressRepository::unlockedQuoteIds()
+{
+    QVector<quint64> ids;
+
+    QSqlQuery *query = statement(SelectUnlockedQuotes);
+    if (!query || !run(query)) return ids;
+
+    while (query->next()) {
+        ids.append(quint64(query->value(0).toLongLong()));
+    }
+    query->finish();
+    return ids;
+}
+
+bool ProgressRepository::unlocksMigrated()
+{
+    bool found = false;
+    getCounter("unlocks_migrated", &found);
+    return found;
+}
+
+bool ProgressRepository::migrateLegacyUnlocks(const QVector<quint64> &quoteIds)
+{
+    if (unlocksMigrated()) return true;
+
+    // Первые сессии по порядку открыли первые цитаты — так работало прежнее правило
+    QSqlQuery sessions(m_db);
+    sessions.setForwardOnly(true);
+    if (!sessions.prepare("SELECT id FROM sessions ORDER BY id LIMIT ?")) {
+        m_lastError = sessions.lastError().text();
+        return false;
+    }
+    sessions.bindValue(0, quoteIds.size());
+    if (!sessions.exec()) {
+        m_lastError = sessions.lastError().text();
+        return false;
+    }
+
+    QVector<int> sessionIds;
+    sessionIds.reserve(quoteIds.size());
+    while (sessions.next()) {
+        sessionIds.append(sessions.value(0).toInt());
+    }
+    sessions.finish();
+
+    for (int i = 0; i < sessionIds.size(); ++i) {
+        if (!unlockQuoteForSession(sessionIds.at(i), quoteIds.at(i))) return false;
+    }
+    return exec("INSERT OR REPLACE INTO counters (name, value) VALUES ('unlocks_migrated', 1)");
+}
+
+QString ProgressRepository::getSetting(const QString &key, const QString &defaultValue, bool *found)
+{
+    if (found) *found = false;
+
+    QSqlQuery *query = statement(SelectSetting);
+    if (!query) return defaultValue;
+
+    query->bindValue(0, key);
+    if (!run(query) || !query->next()) {
+        query->finish();
+        return defaultValue;
+    }
+
+    const QString value = query->value(0).toString();
+    // finish() отпускает блокировку чтения, иначе закэшированный запрос держал бы её
+    query->finish();
+    if (found) *found = true;
+    return value;
+}
+
+bool ProgressRepository::setSetting(const QString &key, const QString &value)
+{
+    QSqlQuery *query = statement(UpsertSetting);
+    if (!query) return false;
+
+    query->bindValue(0, key);
+    query->bindValue(1, value);
+    const bool ok = run(query);
+    query->finish();
+    return ok;
+}
+
+int ProgressRepository::sessionCount()
+{
+    return int(getCounter("sessions"));
+}
+
+qint64 ProgressRepository::getCounter(const QString &name, bool *found)
+{
+    if (found) *found = false;
+
+    QSqlQuery *query = statement(SelectCounter);
+    if (!query) return 0;
+
+    query->bindValue(0, name);
+    if (!run(query) || !query->next()) {
+        query->finish();
+        return 0;
+    }
+
+    const qint64 value = query->value(0).toLongLong();
+    query->finish();
+    if (found) *found = true;
+    return value;
+}
+
+bool ProgressRepository::setCounter(const QString &name, qint64 value)
+{
+    QSqlQuery *query = statement(UpsertCounter);
+    if (!query) return false;
+
+    query->bindValue(0, name);
+    query->bindValue(1, value);
+    const bool ok = run(query);
+    query->finish();
+    return ok;
+}
+
+QList<StatsRow> ProgressRepository::statsRows(StatsPeriod period, const QDate &from, const QDate &to)
+{
+    QList<StatsRow> rows;
+
+    Statement id = SelectStatsDaily;
+    if (period == StatsPeriod::Week) id = SelectStatsWeekly;
+    else if (period == StatsPeriod::Month) id = SelectStatsMonthly;
+
+    QSqlQuery *query = statement(id);
+    if (!query) return rows;
+
+    query->bindValue(0, from.toString(Qt::ISODate));
+    query->bindValue(1, to.toString(Qt::ISODate));
+    if (!run(query)) return rows;
+
+    while (query->next()) {
+        StatsRow row;
+        row.periodStart = QDate::fromString(query->value(0).toString(), Qt::ISODate);
+        row.sessions = query->value(1).toInt();
+        row.minutes = query->value(2).toInt();
+        rows.append(row);
+    }
+    query->finish();
+    return rows;
+}
+
+StatsRow ProgressRepository::statsTotal(const QDate &from, const QDate &to)
+{
+    StatsRow total;
+    total.periodStart = from;
+
+    QSqlQuery *query = statement(SelectStatsTotal);
+    if (!query) return total;
+
+    query->bindValue(0, from.toString(Qt::ISODate));
+    query->bindValue(1, to.toString(Qt::ISODate));
+    if (run(query) && query->next()) {
+        total.sessions = query->value(0).toInt();
+        total.minutes = query->value(1).toInt();
+    }
+    query->finish();
+    return total;
+}
+
+StatsStreaks ProgressRepository::streaks(const QDate &today)
+{
+    StatsStreaks result;
+
+    // Один проход по активным дням от новых к старым: строк не больше, чем дней в истории
+    QSqlQuery *query = statement(SelectActiveDays);
+    if (!query || !run(query)) return result;
+
+    QDate latest;
+    QDate previous;
+    int length = 0;
+    bool inLatestRun = true;   // Ещё идёт самая свежая серия
+    while (query->next()) {
+        const QDate day = QDate::fromString(query->value(0).toString(), Qt::ISODate);
+        if (!latest.isValid()) latest = day;
+
+        if (previous.isValid() && day == previous.addDays(-1)) {
+            length++;
+        } else {
+            if (previous.isValid()) inLatestRun = false;
+            length = 1;
+        }
+        if (inLatestRun) result.current = length;
+        result.longest = qMax(result.longest, length);
+        previous = day;
+    }
+
+    // Самая свежая серия считается текущей, только если она продолжается сегодня или вчера
+    if (!latest.isValid() || latest < today.addDays(-1)) {
+        result.current = 0;
+    }
+    query->finish();
+    return result;
+}
+
+QSqlQuery *ProgressRepository::statement(Statement id)
+{
+    if (!m_db.isOpen()) {
+        m_lastError = "База данных не открыта";
+        return nullptr;
+    }
+
+    if (!m_prepared[id]) {
+        QSqlQuery query(m_db);
+        if (!query.prepare(QString::fromLatin1(kStatementSql[id]))) {
+            m_lastError = query.lastError().text();
+            return nullptr;
+        }
+        m_statements[id] = std::move(query);
+        m_prepared[id] = true;
+    }
+    return &m_statements[id];
+}
+
+bool ProgressRepository::run(QSqlQuery *query)
+{
+    if (!query->exec()) {
+        m_lastError = query->lastError().text();
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,230 @@
+#include "../headers/quotebanner.h"
+#include "../headers/theme.h"
+#include <QEvent>
+#include <QFontMetrics>
+#include <QPainter>
+#include <QPropertyAnimation>
+#include <QTextOption>
+#include <QTimer>
+
+namespace {
+
+constexpr int kMargin = 10;
+constexpr int kMinHeight = 70;
+constexpr int kCornerRadius = 8;
+
+constexpr int kAnnounceMs = 250;
+constexpr int kAnnounceHoldMs = 950;
+constexpr int kRevealMs = 300;
+constexpr int kRevealHoldMs = 2500;
+constexpr int kFadeMs = 400;
+
+QColor mix(const QColor &from, const QColor &to, qreal t)
+{
+    return QColor::fromRgbF(from.redF() + (to.redF() - from.redF()) * t,
+                            from.greenF() + (to.greenF() - from.greenF()) * t,
+                            from.blueF() + (to.blueF() - from.blueF()) * t);
+}
+
+} // namespace
+
+QuoteBanner::QuoteBanner(QWidget *parent)
+    : QWidget(parent)
+    , m_animation(new QPropertyAnimation(this))
+    , m_holdTimer(new QTimer(this))
+{
+    setFont(Theme::quoteFont());
+    setSizePolicy(QSizePolicy::Preferred, QSizePolicy::Minimum);
+    setTheme(Theme::current());
+
+    m_animation->setTargetObject(this);
+    m_animation->setEasingCurve(QEasingCurve::OutCubic);
+    connect(m_animation, &QPropertyAnimation::finished, this, &QuoteBanner::advance);
+
+    m_holdTimer->setSingleShot(true);
+    connect(m_holdTimer, &QTimer::timeout, this, &QuoteBanner::advance);
+}
+
+void QuoteBanner::setText(const QString &text)
+{
+    cancel();
+    showText(text);
+}
+
+void QuoteBanner::reveal(const QString &quote)
+{
+    // Новая сессия могла завершиться во время прошлой анимации: начинаем сначала
+    m_pendingQuote = quote;
+    enterState(State::Announcing);
+}
+
+void QuoteBanner::cancel()
+{
+    if (m_state == State::Idle) return;
+
+    const bool quotePending = m_state == State::Announcing || m_state == State::AnnounceHold;
+    enterState(State::Idle);
+    if (quotePending) {
+        showText(m_pendingQuote);
+    }
+}
+
+void QuoteBanner::setTheme(const Theme &theme)
+{
+    m_textColor = theme.quotePalette().color(QPalette::WindowText);
+    m_revealText = theme.revealText();
+    m_revealBackground = theme.revealBackground();
+    m_highlightText = theme.highlightText();
+    m_highlightBackground = theme.highlightBackground();
+
+    const bool announcing = m_state == State::Announcing || m_state == State::AnnounceHold;
+    m_accentText = announcing ? m_revealText : m_highlightText;
+    m_accentBackground = announcing ? m_revealBackground : m_highlightBackground;
+    update();
+}
+
+void QuoteBanner::setHighlight(qreal value)
+{
+    m_highlight = value;
+    update();
+}
+
+void QuoteBanner::setTextOpacity(qreal value)
+{
+    m_textOpacity = value;
+    update();
+}
+
+void QuoteBanner::advance()
+{
+    switch (m_state) {
+    case State::Announcing:  enterState(State::AnnounceHold); break;
+    case State::AnnounceHold: enterState(State::Revealing); break;
+    case State::Revealing:   enterState(State::RevealHold); break;
+    case State::RevealHold:  enterState(State::Fading); break;
+    case State::Fading:      enterState(State::Idle); break;
+    case State::Idle:        break;
+    }
+}
+
+void QuoteBanner::enterState(State state)
+{
+    // Любой переход отменяет то, что было запланировано в прошлом состоянии
+    m_animation->stop();
+    m_holdTimer->stop();
+    m_state = state;
+
+    switch (state) {
+    case State::Idle:
+        m_highlight = 0.0;
+        m_textOpacity = 1.0;
+        update();
+        break;
+    case State::Announcing:
+        m_accentText = m_revealText;
+        m_accentBackground = m_revealBackground;
+        m_textOpacity = 1.0;
+        showText("✨ Открыта новая цитата!");
+        animate("highlight", 0.0, 1.0, kAnnounceMs);
+        break;
+    case State::AnnounceHold:
+        m_holdTimer->start(kAnnounceHoldMs);
+        break;
+    case State::Revealing:
+        m_accentText = m_highlightText;
+        m_accentBackground = m_highlightBackground;
+        m_highlight = 1.0;
+        showText(m_pendingQuote);
+        animate("textOpacity", 0.0, 1.0, kRevealMs);
+        break;
+    case State::RevealHold:
+        m_holdTimer->start(kRevealHoldMs);
+        break;
+    case State::Fading:
+        animate("highlight", 1.0, 0.0, kFadeMs);
+        break;
+    }
+}
+
+void QuoteBanner::animate(const QByteArray &property, qreal from, qreal to, int durationMs)
+{
+    m_animation->setPropertyName(property);
+    m_animation->setStartValue(from);
+    m_animation->setEndValue(to);
+    m_animation->setDuration(durationMs);
+    m_animation->start();
+}
+
+void QuoteBanner::showText(const QString &text)
+{
+    if (text == m_text) return;
+    m_text = text;
+    prepareText();
+    updateGeometry();
+    update();
+}
+
+void QuoteBanner::prepareText()
+{
+    QTextOption option(Qt::AlignHCenter);
+    option.setWrapMode(QTextOption::WordWrap);
+    m_staticText.setText(m_text);
+    m_staticText.setTextFormat(Qt::PlainText);
+    m_staticText.setTextOption(option);
+    m_staticText.setTextWidth(qMax(0, width() - 2 * kMargin));
+    m_staticText.prepare(QTransform(), font());
+}
+
+int QuoteBanner::heightForWidth(int width) const
+{
+    const QRect bounds = fontMetrics().boundingRect(QRect(0, 0, qMax(0, width - 2 * kMargin), 0),
+                                                    Qt::AlignHCenter | Qt::TextWordWrap, m_text);
+    return qMax(kMinHeight, bounds.height() + 2 * kMargin);
+}
+
+QSize QuoteBanner::sizeHint() const
+{
+    const int width = fontMetrics().averageCharWidth() * 40 + 2 * kMargin;
+    return QSize(width, heightForWidth(width));
+}
+
+QSize QuoteBanner::minimumSizeHint() const
+{
+    return QSize(2 * kMargin, kMinHeight);
+}
+
+void QuoteBanner::paintEvent(QPaintEvent *event)
+{
+    Q_UNUSED(event);
+    QPainter painter(this);
+    painter.setRenderHint(QPainter::Antialiasing);
+
+    if (m_highlight > 0.0) {
+        QColor background = m_accentBackground;
+        background.setAlphaF(m_highlight);
+        painter.setPen(Qt::NoPen);
+        painter.setBrush(background);
+        painter.drawRoundedRect(QRectF(rect()).adjusted(0.5, 0.5, -0.5, -0.5), kCornerRadius, kCornerRadius);
+    }
+
+    painter.setPen(mix(m_textColor, m_accentText, m_highlight));
+    painter.setOpacity(m_textOpacity);
+    const QSizeF textSize = m_staticText.size();
+    const QPointF topLeft(kMargin, (height() - textSize.height()) / 2.0);
+    painter.drawStaticText(topLeft, m_staticText);
+}
+
+void QuoteBanner::resizeEvent(QResizeEvent *event)
+{
+    QWidget::resizeEvent(event);
+    prepareText();
+}
+
+void QuoteBanner::changeEvent(QEvent *event)
+{
+    QWidget::changeEvent(event);
+    if (event->type() == QEvent::FontChange) {
+        prepareText();
+        updateGeometry();
+    }
+}
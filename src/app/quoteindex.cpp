@@ -0,0 +1,162 @@
+#include "../headers/quoteindex.h"
+#include "../headers/quotestore.h"
+#include <QBitArray>
+#include <QHash>
+#include <QTextBoundaryFinder>
+#include <algorithm>
+
+namespace {
+
+// Участок словаря [first, last), слова которого начинаются с prefix
+struct TermRange {
+    int first = 0;
+    int last = 0;
+    int postings = 0;   // Сколько номеров цитат во всех списках участка
+};
+
+} // namespace
+
+void QuoteIndex::build(const QuoteStore &store)
+{
+    clear();
+    m_quoteCount = store.size();
+
+    // Первый проход: пары «слово — цитата», каждая пара один раз на цитату.
+    // Цитаты перебираются по возрастанию, поэтому списки получаются упорядоченными сами
+    QHash<QString, int> termIds;
+    QStringList terms;
+    QVector<int> lastQuote;
+    QVector<int> pairTerm;
+    QVector<int> pairQuote;
+    for (int quote = 0; quote < m_quoteCount; ++quote) {
+        const QStringList words = tokenize(store.text(quote));
+        for (const QString &word : words) {
+            auto it = termIds.constFind(word);
+            if (it == termIds.constEnd()) {
+                it = termIds.insert(word, int(terms.size()));
+                terms.append(word);
+                lastQuote.append(-1);
+            }
+            const int term = it.value();
+            if (lastQuote.at(term) == quote) continue;
+            lastQuote[term] = quote;
+            pairTerm.append(term);
+            pairQuote.append(quote);
+        }
+    }
+
+    // Словарь сортируется, чтобы слова с общим префиксом шли подряд
+    QVector<int> order(terms.size());
+    for (int i = 0; i < order.size(); ++i) order[i] = i;
+    std::sort(order.begin(), order.end(), [&terms](int a, int b) { return terms.at(a) < terms.at(b); });
+    QVector<int> rank(terms.size());
+    m_terms.reserve(terms.size());
+    for (int i = 0; i < order.size(); ++i) {
+        rank[order.at(i)] = i;
+        m_terms.append(terms.at(order.at(i)));
+    }
+
+    // Второй проход — сортировка подсчётом: все списки в одном массиве
+    m_termStart.fill(0, m_terms.size() + 1);
+    for (const int term : pairTerm) {
+        m_termStart[rank.at(term) + 1]++;
+    }
+    for (int i = 0; i < m_terms.size(); ++i) {
+        m_termStart[i + 1] += m_termStart.at(i);
+    }
+    QVector<int> cursor = m_termStart;
+    m_postings.resize(pairQuote.size());
+    for (int i = 0; i < pairQuote.size(); ++i) {
+        m_postings[cursor[rank.at(pairTerm.at(i))]++] = pairQuote.at(i);
+    }
+
+    m_built = true;
+}
+
+void QuoteIndex::clear()
+{
+    m_terms.clear();
+    m_termStart.clear();
+    m_postings.clear();
+    m_quoteCount = 0;
+    m_built = false;
+}
+
+QVector<int> QuoteIndex::search(const QString &query) const
+{
+    QStringList words = tokenize(query);
+    words.removeDuplicates();
+    if (words.isEmpty() || !m_built) return {};
+
+    QVector<TermRange> ranges;
+    ranges.reserve(words.size());
+    for (const QString &word : words) {
+        TermRange range;
+        range.first = int(std::lower_bound(m_terms.cbegin(), m_terms.cend(), word) - m_terms.cbegin());
+        range.last = range.first;
+        while (range.last < m_terms.size() && m_terms.at(range.last).startsWith(word)) {
+            ++range.last;
+        }
+        range.postings = m_termStart.value(range.last) - m_termStart.value(range.first);
+        if (range.postings == 0) return {};
+        ranges.append(range);
+    }
+
+    // Начинаем с самого редкого слова: дальше только отсеиваем его кандидатов
+    std::sort(ranges.begin(), ranges.end(), [](const TermRange &a, const TermRange &b) {
+        return a.postings < b.postings;
+    });
+
+    QBitArray marks(m_quoteCount);
+    auto markRange = [this, &marks](const TermRange &range) {
+        marks.fill(false);
+        for (int i = m_termStart.at(range.first); i < m_termStart.at(range.last); ++i) {
+            marks.setBit(m_postings.at(i));
+        }
+    };
+
+    QVector<int> result;
+    const TermRange &rarest = ranges.constFirst();
+    if (rarest.last - rarest.first == 1) {
+        // Одно слово словаря: его список уже упорядочен
+        result = m_postings.mid(m_termStart.at(rarest.first), rarest.postings);
+    } else {
+        // Префикс совпал с несколькими словами: объединяем их списки через битовую маску
+        markRange(rarest);
+        result.reserve(rarest.postings);
+        for (int quote = 0; quote < m_quoteCount; ++quote) {
+            if (marks.testBit(quote)) result.append(quote);
+        }
+    }
+
+    for (int r = 1; r < ranges.size() && !result.isEmpty(); ++r) {
+        markRange(ranges.at(r));
+        result.erase(std::remove_if(result.begin(), result.end(),
+                                    [&marks](int quote) { return !marks.testBit(quote); }),
+                     result.end());
+    }
+    return result;
+}
+
+QStringList QuoteIndex::tokenize(const QString &text)
+{
+    QStringList words;
+
+    // Границы слов по UAX #29: знаки препинания и пробелы словами не считаются,
+    // кириллица, латиница и цифры разбираются одинаково
+    QTextBoundaryFinder finder(QTextBoundaryFinder::Word, text);
+    int start = -1;
+    for (int position = finder.position(); position >= 0; position = int(finder.toNextBoundary())) {
+        const QTextBoundaryFinder::BoundaryReasons reasons = finder.boundaryReasons();
+        if (start >= 0 && (reasons & QTextBoundaryFinder::EndOfItem)) {
+            QString word = text.mid(start, position - start).toCaseFolded();
+            word.replace(QChar(0x0451), QChar(0x0435));   // ё -> е
+            words.append(word);
+            start = -1;
+        }
+        if (reasons & QTextBoundaryFinder::StartOfItem) {
+            start = position;
+        }
+    }
+    return words;
+}
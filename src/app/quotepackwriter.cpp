@@ -0,0 +1,92 @@
+#include "../headers/quotepackwriter.h"
+#include "../headers/quotepack.h"
+#include "../headers/quotestore.h"
+#include <QByteArray>
+#include <QSaveFile>
+#include <QVector>
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace {
+
+void putUInt16(QByteArray &buffer, int offset, quint16 value)
+{
+    qToLittleEndian<quint16>(value, buffer.data() + offset);
+}
+
+void putUInt32(QByteArray &buffer, int offset, quint32 value)
+{
+    qToLittleEndian<quint32>(value, buffer.data() + offset);
+}
+
+void putUInt64(QByteArray &buffer, int offset, quint64 value)
+{
+    qToLittleEndian<quint64>(value, buffer.data() + offset);
+}
+
+} // namespace
+
+bool QuotePack::write(const QuoteStore &store, const QString &path, QString *error)
+{
+    const int count = store.size();
+    QByteArray table(qsizetype(count) * kEntrySize, Qt::Uninitialized);
+    QByteArray blob;
+    QVector<quint64> ids(count);
+
+    for (int i = 0; i < count; ++i) {
+        // Берём байты строки без перекодирования: после QString битый UTF-8
+        // превратился бы в U+FFFD, и id в пакете разошёлся бы с id из текстового файла
+        const QByteArrayView line = store.bytes(i);
+        if (qint64(blob.size()) + line.size() > qint64(std::numeric_limits<quint32>::max())) {
+            if (error) *error = "Коллекция цитат не помещается в формат .qpack";
+            return false;
+        }
+        const int record = i * kEntrySize;
+        ids[i] = quoteId(line.data(), line.size());
+        putUInt64(table, record + kEntryIdField, ids.at(i));
+        putUInt32(table, record + kEntryOffsetField, quint32(blob.size()));
+        putUInt32(table, record + kEntryLengthField, quint32(line.size()));
+        blob.append(line);
+    }
+
+    // Индекс по идентификаторам: номера записей, упорядоченные по id.
+    // По нему приложение находит открытые цитаты двоичным поиском, не перебирая всю коллекцию
+    QVector<quint32> order(count);
+    for (int i = 0; i < count; ++i) order[i] = quint32(i);
+    std::stable_sort(order.begin(), order.end(), [&ids](quint32 a, quint32 b) {
+        return ids.at(int(a)) < ids.at(int(b));
+    });
+    QByteArray idIndex(qsizetype(count) * sizeof(quint32), Qt::Uninitialized);
+    for (int i = 0; i < count; ++i) {
+        putUInt32(idIndex, i * int(sizeof(quint32)), order.at(i));
+    }
+
+    quint32 crc = crc32(reinterpret_cast<const uchar *>(table.constData()), table.size());
+    crc = crc32(reinterpret_cast<const uchar *>(idIndex.constData()), idIndex.size(), crc);
+    crc = crc32(reinterpret_cast<const uchar *>(blob.constData()), blob.size(), crc);
+
+    QByteArray header(kHeaderSize, '\0');
+    std::memcpy(header.data(), kMagic, sizeof(kMagic));
+    putUInt16(header, kVersionField, kVersion);
+    putUInt16(header, kHeaderSizeField, kHeaderSize);
+    putUInt32(header, kCountField, quint32(count));
+    putUInt32(header, kTableOffsetField, quint32(kHeaderSize));
+    putUInt32(header, kBlobOffsetField, quint32(kHeaderSize + table.size() + idIndex.size()));
+    putUInt32(header, kBlobSizeField, quint32(blob.size()));
+    putUInt32(header, kChecksumField, crc);
+    putUInt32(header, kIdIndexOffsetField, quint32(kHeaderSize + table.size()));
+
+    // QSaveFile подменяет файл атомарно, так что недописанный пакет не попадёт к приложению
+    QSaveFile out(path);
+    if (!out.open(QIODevice::WriteOnly)
+        || out.write(header) != header.size()
+        || out.write(table) != table.size()
+        || out.write(idIndex) != idIndex.size()
+        || out.write(blob) != blob.size()
+        || !out.commit()) {
+        if (error) *error = out.errorString();
+        return false;
+    }
+    return true;
+}
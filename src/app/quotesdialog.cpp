@@ -1,71 +1,31 @@
 #include "../headers/quotesdialog.h"
-#include <QHBoxLayout>
-#include <QScrollArea>
+#include "../headers/quotesmodel.h"
+#include "../headers/quotestore.h"
+#include "../headers/quoteindex.h"
+#include "../headers/theme.h"
+#include "../headers/trace.h"
 #include <QFont>
-#include <QPainter>
-#include <QStyleOption>
 #include <QPushButton>
 #include <QLabel>
+#include <QLineEdit>
+#include <QListView>
+#include <QElapsedTimer>
+#include <QDebug>
 #include <QVBoxLayout>
-#include <QApplication>
 #include <algorithm>
 
-QuoteItem::QuoteItem(const QString &text, bool unlocked, QWidget *parent)
-    : QWidget(parent)
-{
-    setMinimumHeight(60);
-    setStyleSheet("border: 1px solid #ddd; border-radius: 6px; background: white; margin: 2px 0;");
-
-    auto *layout = new QHBoxLayout(this);
-    layout->setContentsMargins(15, 10, 15, 10);
-
-    // Круглый значок в виде зелёной галочки для открытых цитат и серого знака вопроса для закрытых
-    auto *iconLabel = new QLabel(this);
-    iconLabel->setFixedSize(36, 36);
-    iconLabel->setAlignment(Qt::AlignCenter);
-    iconLabel->setFont(QFont("Sans", 16, QFont::Bold));
-
-    if (unlocked) {
-        iconLabel->setText("✓");
-        iconLabel->setStyleSheet("QLabel { color: white; background-color: #27ae60; border-radius: 18px; }");
-    } else {
-        iconLabel->setText("?");
-        iconLabel->setStyleSheet("QLabel { color: white; background-color: #95a5a6; border-radius: 18px; }");
-    }
-
-    // Текст цитаты или заглушка не открыта для закрытых позиций
-    auto *textLabel = new QLabel(unlocked ? text : "🔒 Эта цитата ещё не открыта", this);
-    textLabel->setWordWrap(true);
-    textLabel->setFont(QFont("Sans", 12));
-    textLabel->setStyleSheet(unlocked ?
-                                 "QLabel { color: #2c3e50; font-style: italic; }" :
-                                 "QLabel { color: #95a5a6; font-style: italic; }"
-                             );
-
-    layout->addWidget(iconLabel);
-    layout->addWidget(textLabel);
-    layout->addStretch();
-}
-
-// Переопределяем paintEvent, чтобы QSS-стили корректно применялись к кастомному QWidget
-void QuoteItem::paintEvent(QPaintEvent *event)
-{
-    Q_UNUSED(event);
-    QStyleOption opt;
-    opt.initFrom(this);
-    QPainter p(this);
-    style()->drawPrimitive(QStyle::PE_Widget, &opt, &p, this);
-}
-
-QuotesDialog::QuotesDialog(const QList<QPair<QString, bool>> &quotes, QWidget *parent)
+QuotesDialog::QuotesDialog(const QuoteStore *store, QuoteIndex *index, QWidget *parent)
     : QDialog(parent)
+    , m_store(store)
+    , m_index(index)
 {
+    Trace::Span span("создание коллекции");
     setWindowTitle("Моя коллекция цитат 📚");
     setMinimumSize(450, 500);
-    setupUI(quotes);
+    setupUI();
 }
 
-void QuotesDialog::setupUI(const QList<QPair<QString, bool>> &quotes)
+void QuotesDialog::setupUI()
 {
     auto *mainLayout = new QVBoxLayout(this);
     mainLayout->setSpacing(12);
@@ -75,48 +35,100 @@ void QuotesDialog::setupUI(const QList<QPair<QString, bool>> &quotes)
     m_progressLabel = new QLabel(this);
     m_progressLabel->setAlignment(Qt::AlignCenter);
     m_progressLabel->setFont(QFont("Sans", 18, QFont::Bold));
-    int unlocked = std::count_if(quotes.begin(), quotes.end(),
-                                 [](const QPair<QString, bool> &q) { return q.second; });
-    m_progressLabel->setText(QString("Открыто цитат: %1 из %2")
-                                 .arg(unlocked).arg(quotes.size()));
-    m_progressLabel->setStyleSheet("QLabel { color: #2980b9; padding: 8px; background-color: #e3f2fd; border-radius: 6px; }");
-
-    // Прокручиваемый список всех цитат
-    auto *scrollArea = new QScrollArea(this);
-    scrollArea->setWidgetResizable(true);
-    scrollArea->setFrameShape(QFrame::NoFrame);
-
-    auto *scrollWidget = new QWidget(scrollArea);
-    auto *scrollLayout = new QVBoxLayout(scrollWidget);
-    scrollLayout->setSpacing(4);
-    scrollLayout->setContentsMargins(0, 0, 0, 0);
-
-    for (int i = 0; i < quotes.size(); ++i) {
-        // Нумеруем цитату для удобства навигации по коллекции
-        QString displayText = QString("%1. %2").arg(i + 1).arg(quotes[i].first);
-        auto *item = new QuoteItem(displayText, quotes[i].second);
-        scrollLayout->addWidget(item);
-    }
-    scrollLayout->addStretch(1);
-    scrollWidget->setLayout(scrollLayout);
-    scrollArea->setWidget(scrollWidget);
+    m_progressLabel->setMargin(8);
+    m_progressLabel->setAutoFillBackground(true);
+    m_progressLabel->setPalette(Theme::current().infoPalette());
+
+    // Поиск только по открытым цитатам: текст закрытых не должен подсказываться
+    m_searchEdit = new QLineEdit(this);
+    m_searchEdit->setPlaceholderText("🔍 Поиск по открытым цитатам");
+    m_searchEdit->setClearButtonEnabled(true);
+    connect(m_searchEdit, &QLineEdit::textChanged, this, &QuotesDialog::applySearch);
+
+    // Прокручиваемый список всех цитат. uniformItemSizes избавляет QListView
+    // от вызова sizeHint для каждой строки, а делегат рисует только видимые
+    m_model = new QuotesModel(m_store, this);
+    m_listView = new QListView(this);
+    m_listView->setModel(m_model);
+    m_listView->setItemDelegate(new QuoteDelegate(m_listView));
+    m_listView->setUniformItemSizes(true);
+    m_listView->setVerticalScrollMode(QAbstractItemView::ScrollPerPixel);
+    m_listView->setSelectionMode(QAbstractItemView::NoSelection);
+    m_listView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_listView->setFrameShape(QFrame::NoFrame);
 
     // Подсказка с процентом прохождения коллекции
-    auto *statsLabel = new QLabel(this);
-    statsLabel->setWordWrap(true);
-    statsLabel->setAlignment(Qt::AlignCenter);
-    statsLabel->setStyleSheet("QLabel { color: #7f8c8d; font-size: 13px; margin: 8px 0; }");
-    statsLabel->setText(QString(
-                            "💡 Каждая завершённая сессия открывает одну новую цитату.\n"
-                            "Ты на %1% пути к полной коллекции!"
-                            ).arg(qRound(unlocked * 100.0 / qMax(1, quotes.size()))));
+    m_statsLabel = new QLabel(this);
+    m_statsLabel->setWordWrap(true);
+    m_statsLabel->setAlignment(Qt::AlignCenter);
+    QFont statsFont = m_statsLabel->font();
+    statsFont.setPixelSize(13);
+    m_statsLabel->setFont(statsFont);
+    m_statsLabel->setContentsMargins(0, 8, 0, 8);
+    m_statsLabel->setForegroundRole(QPalette::PlaceholderText);
 
     auto *closeButton = new QPushButton("Закрыть", this);
     closeButton->setMinimumHeight(36);
     connect(closeButton, &QPushButton::clicked, this, &QDialog::accept);
 
     mainLayout->addWidget(m_progressLabel);
-    mainLayout->addWidget(scrollArea, 1);
-    mainLayout->addWidget(statsLabel);
+    mainLayout->addWidget(m_searchEdit);
+    mainLayout->addWidget(m_listView, 1);
+    mainLayout->addWidget(m_statsLabel);
     mainLayout->addWidget(closeButton);
-}
\ No newline at end of file
+
+    updateProgress();
+}
+
+void QuotesDialog::updateProgress()
+{
+    const int unlocked = m_store->unlockedCount();
+    const int total = m_store->size();
+    m_progressLabel->setText(QString("Открыто цитат: %1 из %2").arg(unlocked).arg(total));
+    if (m_model->isFiltered()) {
+        m_statsLabel->setText(m_model->rowCount() > 0
+                                  ? QString("Найдено цитат: %1").arg(m_model->rowCount())
+                                  : QString("Среди открытых цитат ничего не нашлось"));
+        return;
+    }
+    m_statsLabel->setText(QString(
+                              "💡 Каждая завершённая сессия открывает одну новую цитату.\n"
+                              "Ты на %1% пути к полной коллекции!"
+                              ).arg(qRound(unlocked * 100.0 / qMax(1, total))));
+}
+
+void QuotesDialog::quotesReloaded(const QuoteDiff &diff)
+{
+    // Открытия привязаны к идентификаторам, поэтому вне заменённого участка не меняются
+    m_model->applyDiff(diff);
+    if (!m_searchEdit->text().isEmpty()) {
+        applySearch();   // Номера найденных цитат сдвинулись, ищем по новой коллекции
+    }
+    updateProgress();
+}
+
+void QuotesDialog::applySearch()
+{
+    Trace::Span span("поиск цитат");
+    const QString query = m_searchEdit->text();
+    if (query.trimmed().isEmpty()) {
+        m_model->clearFilter();
+        updateProgress();
+        return;
+    }
+
+    // Индекс строится один раз на версию коллекции; обычно это уже сделано при запуске в фоне
+    if (!m_index->isBuilt()) {
+        QElapsedTimer timer;
+        timer.start();
+        m_index->build(*m_store);
+        qDebug() << "Поисковый индекс построен за" << timer.elapsed() << "мс, слов:" << m_index->termCount();
+    }
+
+    QVector<int> found = m_index->search(query);
+    found.erase(std::remove_if(found.begin(), found.end(),
+                               [this](int quote) { return !m_store->isUnlocked(quote); }),
+                found.end());
+    m_model->setFilter(found);
+    updateProgress();
+}
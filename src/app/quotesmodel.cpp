@@ -0,0 +1,193 @@
+#include "../headers/quotesmodel.h"
+#include "../headers/quotestore.h"
+#include <QPainter>
+#include <QTextLayout>
+#include <QFontMetrics>
+
+namespace {
+
+constexpr int kBadgeSize = 36;
+constexpr int kHPadding = 15;
+constexpr int kVPadding = 10;
+constexpr int kCardMargin = 2;
+constexpr int kMaxTextLines = 3;
+
+// Переносит текст по словам в пределах rect; если строк больше, чем помещается,
+// последнюю видимую строку обрезает многоточием
+void drawWrappedText(QPainter *painter, const QRect &rect, const QString &text, const QFont &font)
+{
+    const QFontMetrics fm(font);
+    const int lineHeight = fm.lineSpacing();
+    const int maxLines = qMax(1, rect.height() / lineHeight);
+
+    QTextLayout layout(text, font);
+    QTextOption textOption;
+    textOption.setWrapMode(QTextOption::WrapAtWordBoundaryOrAnywhere);
+    layout.setTextOption(textOption);
+
+    QStringList lines;
+    layout.beginLayout();
+    for (;;) {
+        QTextLine line = layout.createLine();
+        if (!line.isValid()) break;
+        line.setLineWidth(rect.width());
+        if (lines.size() == maxLines - 1) {
+            lines << fm.elidedText(text.mid(line.textStart()), Qt::ElideRight, rect.width());
+            break;
+        }
+        lines << text.mid(line.textStart(), line.textLength()).trimmed();
+    }
+    layout.endLayout();
+
+    // Центрируем блок строк по вертикали внутри карточки
+    int y = rect.top() + (rect.height() - int(lines.size()) * lineHeight) / 2;
+    for (const QString &line : lines) {
+        painter->drawText(QRect(rect.left(), y, rect.width(), lineHeight),
+                          Qt::AlignLeft | Qt::AlignVCenter, line);
+        y += lineHeight;
+    }
+}
+
+} // namespace
+
+QuotesModel::QuotesModel(const QuoteStore *store, QObject *parent)
+    : QAbstractListModel(parent)
+    , m_store(store)
+    , m_rowCount(store->size())
+{
+}
+
+int QuotesModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid()) return 0;
+    return m_filtered ? int(m_filter.size()) : m_rowCount;
+}
+
+QVariant QuotesModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid()) return {};
+
+    const int row = m_filtered ? m_filter.value(index.row(), -1) : index.row();
+    if (row < 0 || row >= m_store->size()) return {};
+    const bool unlocked = m_store->isUnlocked(row);
+
+    switch (role) {
+    case Qt::DisplayRole:
+        // Нумеруем открытую цитату для удобства навигации, закрытые показываем заглушкой
+        return unlocked ? QString("%1. %2").arg(row + 1).arg(m_store->text(row))
+                        : QString("🔒 Эта цитата ещё не открыта");
+    case Qt::ToolTipRole:
+        // Полный текст на случай, если цитата не поместилась в карточку
+        return unlocked ? QVariant(m_store->text(row)) : QVariant();
+    case UnlockedRole:
+        return unlocked;
+    default:
+        return {};
+    }
+}
+
+void QuotesModel::applyDiff(const QuoteDiff &diff)
+{
+    // Номера отфильтрованных цитат после правки файла устарели,
+    // фильтр заново задаёт диалог, повторив поиск
+    if (m_filtered) {
+        beginResetModel();
+        m_rowCount = m_store->size();
+        m_filter.clear();
+        m_filtered = false;
+        endResetModel();
+        return;
+    }
+
+    // Правка строк без изменения их числа — это просто обновление данных
+    const int replaced = qMin(diff.removed, diff.inserted);
+    if (replaced > 0) {
+        emit dataChanged(index(diff.first), index(diff.first + replaced - 1));
+    }
+    if (diff.removed > replaced) {
+        const int first = diff.first + replaced;
+        beginRemoveRows(QModelIndex(), first, diff.first + diff.removed - 1);
+        m_rowCount -= diff.removed - replaced;
+        endRemoveRows();
+    }
+    if (diff.inserted > replaced) {
+        const int first = diff.first + replaced;
+        beginInsertRows(QModelIndex(), first, diff.first + diff.inserted - 1);
+        m_rowCount += diff.inserted - replaced;
+        endInsertRows();
+    }
+}
+
+void QuotesModel::setFilter(const QVector<int> &quotes)
+{
+    // С uniformItemSizes сброс модели дешёвый: представление заново
+    // запрашивает только видимые строки
+    beginResetModel();
+    m_filter = quotes;
+    m_filtered = true;
+    endResetModel();
+}
+
+void QuotesModel::clearFilter()
+{
+    if (!m_filtered) return;
+    beginResetModel();
+    m_filter.clear();
+    m_filtered = false;
+    endResetModel();
+}
+
+QuoteDelegate::QuoteDelegate(QObject *parent)
+    : QStyledItemDelegate(parent)
+    , m_badgeFont("Sans", 16, QFont::Bold)
+    , m_textFont("Sans", 12)
+{
+    m_textFont.setItalic(true);
+    m_rowHeight = qMax(kBadgeSize, kMaxTextLines * QFontMetrics(m_textFont).lineSpacing())
+                  + 2 * (kVPadding + kCardMargin);
+}
+
+void QuoteDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option,
+                          const QModelIndex &index) const
+{
+    const bool unlocked = index.data(QuotesModel::UnlockedRole).toBool();
+    const QString text = index.data(Qt::DisplayRole).toString();
+
+    painter->save();
+    painter->setRenderHint(QPainter::Antialiasing);
+
+    // Карточка с рамкой и скруглёнными углами
+    const QRectF card = QRectF(option.rect).adjusted(0.5, kCardMargin + 0.5, -0.5, -kCardMargin - 0.5);
+    // Цвета берутся из ролей палитры, поэтому карточки следуют за темой без таблиц стилей
+    painter->setPen(option.palette.color(QPalette::Mid));
+    painter->setBrush(option.palette.base());
+    painter->drawRoundedRect(card, 6, 6);
+
+    // Круглый значок в виде зелёной галочки для открытых цитат и серого знака вопроса для закрытых
+    const QRect badge(option.rect.left() + kHPadding,
+                      option.rect.center().y() - kBadgeSize / 2,
+                      kBadgeSize, kBadgeSize);
+    painter->setPen(Qt::NoPen);
+    painter->setBrush(unlocked ? QColor(0x27, 0xae, 0x60) : option.palette.color(QPalette::PlaceholderText));
+    painter->drawEllipse(badge);
+    painter->setPen(Qt::white);
+    painter->setFont(m_badgeFont);
+    painter->drawText(badge, Qt::AlignCenter, unlocked ? QStringLiteral("✓") : QStringLiteral("?"));
+
+    const QRect textRect = option.rect.adjusted(2 * kHPadding + kBadgeSize, kVPadding + kCardMargin,
+                                                -kHPadding, -kVPadding - kCardMargin);
+    painter->setPen(option.palette.color(unlocked ? QPalette::Text : QPalette::PlaceholderText));
+    painter->setFont(m_textFont);
+    drawWrappedText(painter, textRect, text, m_textFont);
+
+    painter->restore();
+}
+
+QSize QuoteDelegate::sizeHint(const QStyleOptionViewItem &option, const QModelIndex &index) const
+{
+    Q_UNUSED(option);
+    Q_UNUSED(index);
+    // Ширину задаёт сам QListView (элемент растягивается на всю ширину окна),
+    // высота одинакова для всех строк
+    return QSize(2 * kHPadding + kBadgeSize, m_rowHeight);
+}
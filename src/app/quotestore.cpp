@@ -0,0 +1,417 @@
+#include "../headers/quotestore.h"
+#include "../headers/quotepack.h"
+#include <QDebug>
+#include <QSet>
+#include <cstring>
+#include <limits>
+
+namespace {
+
+inline bool isBlank(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+} // namespace
+
+bool QuoteStore::loadFile(const QString &path)
+{
+    clear();
+
+    m_file->setFileName(path);
+    if (!m_file->open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    // Индекс хранит 32-битные смещения, файлы больше 4 ГБ не поддерживаются
+    const qint64 fileSize = m_file->size();
+    if (fileSize > qint64(std::numeric_limits<quint32>::max())) {
+        qWarning() << "Файл цитат слишком большой:" << path;
+        m_file->close();
+        return false;
+    }
+
+    if (fileSize > 0) {
+        if (uchar *mapped = m_file->map(0, fileSize)) {
+            m_data = reinterpret_cast<const char *>(mapped);
+        } else {
+            // Например, файловая система не поддерживает mmap, тогда читаем целиком
+            m_buffer = m_file->readAll();
+            m_file->close();
+            m_data = m_buffer.constData();
+        }
+        m_dataSize = fileSize;
+    }
+
+    buildIndex();
+    fitUnlocked();
+    return true;
+}
+
+bool QuoteStore::loadPack(const QString &path)
+{
+    using namespace QuotePack;
+
+    clear();
+
+    m_file->setFileName(path);
+    if (!m_file->open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    const qint64 fileSize = m_file->size();
+    const uchar *mapped = fileSize >= kHeaderSize ? m_file->map(0, fileSize) : nullptr;
+    if (!mapped) {
+        clear();
+        return false;
+    }
+
+    const quint32 count = qFromLittleEndian<quint32>(mapped + kCountField);
+    const quint32 tableOffset = qFromLittleEndian<quint32>(mapped + kTableOffsetField);
+    const quint32 blobOffset = qFromLittleEndian<quint32>(mapped + kBlobOffsetField);
+    const quint32 blobSize = qFromLittleEndian<quint32>(mapped + kBlobSizeField);
+    const quint16 version = qFromLittleEndian<quint16>(mapped + kVersionField);
+    const quint32 idIndexOffset = version >= 2 ? qFromLittleEndian<quint32>(mapped + kIdIndexOffsetField) : 0;
+    const qint64 tableSize = qint64(count) * kEntrySize;
+    const qint64 idIndexSize = idIndexOffset ? qint64(count) * qint64(sizeof(quint32)) : 0;
+
+    // Проверяем заголовок, контрольную сумму и границы записей. Тексты не декодируем
+    QString error;
+    if (std::memcmp(mapped, kMagic, sizeof(kMagic)) != 0) {
+        error = "неверная сигнатура";
+    } else if (version < kMinVersion || version > kVersion
+               || qFromLittleEndian<quint16>(mapped + kHeaderSizeField) != kHeaderSize) {
+        error = "неподдерживаемая версия формата";
+    } else if (count > quint32(std::numeric_limits<int>::max())
+               || tableOffset + tableSize > fileSize
+               || qint64(idIndexOffset) + idIndexSize > fileSize
+               || qint64(blobOffset) + blobSize > fileSize) {
+        error = "повреждённый заголовок";
+    } else {
+        quint32 crc = crc32(mapped + tableOffset, tableSize);
+        if (idIndexOffset) {
+            crc = crc32(mapped + idIndexOffset, idIndexSize, crc);
+        }
+        crc = crc32(mapped + blobOffset, blobSize, crc);
+        if (crc != qFromLittleEndian<quint32>(mapped + kChecksumField)) {
+            error = "не совпадает контрольная сумма";
+        }
+    }
+    // Контрольная сумма не защищает от собранного с ошибкой или подделанного пакета,
+    // а entryAt и indexOf читают по этим числам без проверок. Поэтому каждая запись
+    // должна лежать внутри блока текстов, а индекс — ссылаться на существующие записи
+    for (quint32 i = 0; error.isEmpty() && i < count; ++i) {
+        const uchar *record = mapped + tableOffset + qsizetype(i) * kEntrySize;
+        const qint64 end = qint64(qFromLittleEndian<quint32>(record + kEntryOffsetField))
+                           + qFromLittleEndian<quint32>(record + kEntryLengthField);
+        if (end > blobSize) {
+            error = QString("запись %1 выходит за блок текстов").arg(i);
+        } else if (idIndexOffset
+                   && qFromLittleEndian<quint32>(mapped + idIndexOffset + qsizetype(i) * sizeof(quint32)) >= count) {
+            error = QString("индекс по идентификаторам ссылается за таблицу записей");
+        }
+    }
+
+    if (!error.isEmpty()) {
+        qWarning() << "Пакет цитат" << path << "отклонён:" << error;
+        clear();
+        return false;
+    }
+
+    m_packTable = mapped + tableOffset;
+    m_packIdIndex = idIndexOffset ? mapped + idIndexOffset : nullptr;
+    m_data = reinterpret_cast<const char *>(mapped + blobOffset);
+    m_dataSize = blobSize;
+    m_count = int(count);
+    fitUnlocked();
+    return true;
+}
+
+void QuoteStore::setQuotes(const QStringList &quotes)
+{
+    clear();
+    m_buffer = quotes.join('\n').toUtf8();
+    m_data = m_buffer.constData();
+    m_dataSize = m_buffer.size();
+    buildIndex();
+    fitUnlocked();
+}
+
+bool QuoteStore::reloadFile(const QString &path, QuoteDiff *diff)
+{
+    QuoteStore next;
+    if (!next.loadFile(path)) {
+        return false;
+    }
+    next.buildIds();
+    buildIds();
+
+    // Общие начало и конец находятся сравнением 64-битных идентификаторов,
+    // так что правка одной строки в большом файле затрагивает одну позицию
+    const int oldCount = m_count;
+    const int newCount = next.m_count;
+    int prefix = 0;
+    while (prefix < oldCount && prefix < newCount && m_ids.at(prefix) == next.m_ids.at(prefix)) {
+        ++prefix;
+    }
+    int suffix = 0;
+    while (suffix < oldCount - prefix && suffix < newCount - prefix
+           && m_ids.at(oldCount - 1 - suffix) == next.m_ids.at(newCount - 1 - suffix)) {
+        ++suffix;
+    }
+
+    QuoteDiff result;
+    result.first = prefix;
+    result.removed = oldCount - prefix - suffix;
+    result.inserted = newCount - prefix - suffix;
+
+    // Статус открытия: начало и конец переносятся по позиции, а заменённый
+    // участок — по идентификатору. Так переставленная строка остаётся открытой
+    QSet<quint64> unlockedIds;
+    for (int i = prefix; i < prefix + result.removed; ++i) {
+        if (m_unlocked.testBit(i)) unlockedIds.insert(m_ids.at(i));
+    }
+    const quint64 lastId = m_lastUnlocked >= 0 ? m_ids.at(m_lastUnlocked) : 0;
+
+    QBitArray unlocked(newCount);
+    for (int i = 0; i < prefix; ++i) {
+        unlocked.setBit(i, m_unlocked.testBit(i));
+    }
+    for (int i = 0; i < suffix; ++i) {
+        unlocked.setBit(newCount - 1 - i, m_unlocked.testBit(oldCount - 1 - i));
+    }
+    for (int i = prefix; i < prefix + result.inserted; ++i) {
+        if (unlockedIds.contains(next.m_ids.at(i))) unlocked.setBit(i);
+    }
+
+    int last = -1;
+    if (m_lastUnlocked >= 0 && m_lastUnlocked < prefix) {
+        last = m_lastUnlocked;
+    } else if (m_lastUnlocked >= oldCount - suffix) {
+        last = m_lastUnlocked + newCount - oldCount;
+    } else if (m_lastUnlocked >= 0) {
+        for (int i = prefix; i < prefix + result.inserted; ++i) {
+            if (next.m_ids.at(i) == lastId && unlocked.testBit(i)) {
+                last = i;
+                break;
+            }
+        }
+    }
+
+    takeContents(next);
+    m_unlocked = unlocked;
+    m_unlockedCount = int(m_unlocked.count(true));
+    m_lastUnlocked = last;
+    fitUnlocked();
+
+    if (diff) *diff = result;
+    return true;
+}
+
+QuoteStore::Entry QuoteStore::entryAt(int index) const
+{
+    if (m_packTable) {
+        const uchar *record = m_packTable + qsizetype(index) * QuotePack::kEntrySize;
+        return {qFromLittleEndian<quint32>(record + QuotePack::kEntryOffsetField),
+                qFromLittleEndian<quint32>(record + QuotePack::kEntryLengthField)};
+    }
+    return m_index.at(index);
+}
+
+QString QuoteStore::text(int index) const
+{
+    const Entry entry = entryAt(index);
+    return QString::fromUtf8(m_data + entry.offset, qsizetype(entry.length));
+}
+
+QByteArrayView QuoteStore::bytes(int index) const
+{
+    const Entry entry = entryAt(index);
+    return QByteArrayView(m_data + entry.offset, qsizetype(entry.length));
+}
+
+quint64 QuoteStore::id(int index) const
+{
+    // В пакете идентификатор уже посчитан при сборке
+    if (m_packTable) {
+        const uchar *record = m_packTable + qsizetype(index) * QuotePack::kEntrySize;
+        return qFromLittleEndian<quint64>(record + QuotePack::kEntryIdField);
+    }
+    if (!m_ids.isEmpty()) {
+        return m_ids.at(index);
+    }
+    const QByteArrayView line = bytes(index);
+    return QuotePack::quoteId(line.data(), line.size());
+}
+
+int QuoteStore::indexOf(quint64 id) const
+{
+    // Пакет версии 2 несёт отсортированный индекс: двоичный поиск прямо по
+    // отображённому файлу, без подготовки и без выделения памяти
+    if (m_packIdIndex) {
+        int low = 0;
+        int high = m_count;
+        while (low < high) {
+            const int middle = low + (high - low) / 2;
+            const int entry = int(qFromLittleEndian<quint32>(m_packIdIndex + qsizetype(middle) * sizeof(quint32)));
+            if (this->id(entry) < id) {
+                low = middle + 1;
+            } else {
+                high = middle;
+            }
+        }
+        if (low < m_count) {
+            const int entry = int(qFromLittleEndian<quint32>(m_packIdIndex + qsizetype(low) * sizeof(quint32)));
+            if (this->id(entry) == id) return entry;
+        }
+        return -1;
+    }
+
+    // Текстовый источник и пакет версии 1: хеш-таблица строится один раз на
+    // загрузку. При повторах строк побеждает первая, как и в индексе пакета
+    if (m_idLookup.isEmpty() && m_count > 0) {
+        m_idLookup.reserve(m_count);
+        for (int i = m_count - 1; i >= 0; --i) {
+            m_idLookup.insert(this->id(i), i);
+        }
+    }
+    return m_idLookup.value(id, -1);
+}
+
+int QuoteStore::setUnlockedIds(const QVector<quint64> &ids)
+{
+    m_unlocked.fill(false, m_count);
+    m_unlockedCount = 0;
+    m_lastUnlocked = -1;
+
+    for (const quint64 id : ids) {
+        const int index = indexOf(id);
+        if (index < 0 || m_unlocked.testBit(index)) continue;
+        m_unlocked.setBit(index);
+        m_unlockedCount++;
+        m_lastUnlocked = index;
+    }
+    return m_unlockedCount;
+}
+
+void QuoteStore::setUnlockedCount(int count)
+{
+    m_unlockedCount = qBound(0, count, m_count);
+    m_unlocked.fill(false, m_count);
+    if (m_unlockedCount > 0) {
+        m_unlocked.fill(true, 0, m_unlockedCount);
+    }
+    m_lastUnlocked = m_unlockedCount - 1;
+}
+
+int QuoteStore::unlockNext()
+{
+    if (m_unlockedCount >= m_count) return -1;
+
+    // Закрытые цитаты открываются в порядке файла. Повтор строки — та же цитата
+    // с тем же идентификатором, а из бд она восстанавливается по первой копии
+    // (indexOf). Поэтому повторы не открываются: иначе после перезапуска
+    // открытая копия снова оказалась бы закрытой и открывалась бы заново
+    for (int index = 0; index < m_count; ++index) {
+        if (m_unlocked.testBit(index) || indexOf(id(index)) != index) continue;
+        m_unlocked.setBit(index);
+        m_unlockedCount++;
+        m_lastUnlocked = index;
+        return index;
+    }
+    return -1;
+}
+
+void QuoteStore::fitUnlocked()
+{
+    // Для новой коллекции сохраняются биты первых позиций, как раньше сохранялся счётчик
+    if (m_unlocked.size() != m_count) {
+        m_unlocked.resize(m_count);
+        m_unlockedCount = int(m_unlocked.count(true));
+    }
+    if (m_lastUnlocked >= m_count || (m_lastUnlocked >= 0 && !m_unlocked.testBit(m_lastUnlocked))) {
+        m_lastUnlocked = m_count - 1;
+        while (m_lastUnlocked >= 0 && !m_unlocked.testBit(m_lastUnlocked)) --m_lastUnlocked;
+    }
+}
+
+void QuoteStore::buildIds()
+{
+    if (m_ids.size() == m_count) return;
+
+    QVector<quint64> ids(m_count);
+    for (int i = 0; i < m_count; ++i) {
+        ids[i] = id(i);
+    }
+    m_ids.swap(ids);
+}
+
+void QuoteStore::takeContents(QuoteStore &other)
+{
+    // QByteArray::swap меняет только указатели, поэтому m_data остаётся верным
+    std::swap(m_file, other.m_file);
+    m_buffer.swap(other.m_buffer);
+    std::swap(m_data, other.m_data);
+    std::swap(m_dataSize, other.m_dataSize);
+    std::swap(m_packTable, other.m_packTable);
+    std::swap(m_packIdIndex, other.m_packIdIndex);
+    m_index.swap(other.m_index);
+    m_ids.swap(other.m_ids);
+    m_idLookup.swap(other.m_idLookup);
+    std::swap(m_count, other.m_count);
+}
+
+void QuoteStore::clear()
+{
+    // QFile::close снимает и отображение в память
+    if (m_file->isOpen()) {
+        m_file->close();
+    }
+    m_buffer.clear();
+    m_data = nullptr;
+    m_dataSize = 0;
+    m_packTable = nullptr;
+    m_packIdIndex = nullptr;
+    m_index.clear();
+    m_ids.clear();
+    m_idLookup.clear();
+    m_count = 0;
+}
+
+void QuoteStore::buildIndex()
+{
+    m_index.clear();
+    if (!m_data) {
+        return;
+    }
+
+    const char *begin = m_data;
+    const char *end = m_data + m_dataSize;
+    const char *pos = begin;
+
+    // Пропускаем BOM, если файл сохранён с ним
+    if (m_dataSize >= 3 && std::memcmp(pos, "\xEF\xBB\xBF", 3) == 0) {
+        pos += 3;
+    }
+
+    // Один проход по буферу: memchr ищет переводы строк векторными инструкциями libc,
+    // а обрезка пробелов затрагивает только края каждой строки
+    while (pos < end) {
+        const char *newline = static_cast<const char *>(std::memchr(pos, '\n', size_t(end - pos)));
+        const char *lineEnd = newline ? newline : end;
+
+        const char *first = pos;
+        const char *last = lineEnd;
+        while (first < last && isBlank(*first)) ++first;
+        while (last > first && isBlank(last[-1])) --last;
+
+        // Пропускаем пустые строки и строки-комментарии
+        if (first < last && *first != '#') {
+            m_index.append({quint32(first - begin), quint32(last - first)});
+        }
+        pos = newline ? newline + 1 : end;
+    }
+
+    m_index.squeeze();
+    m_count = int(m_index.size());
+}
@@ -0,0 +1,320 @@
+#include "../headers/sessionjournal.h"
+#include "../headers/quotepack.h"
+#include "../headers/trace.h"
+#include <QByteArray>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QSaveFile>
+#include <QTimer>
+#include <QtEndian>
+#include <QDebug>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <utility>
+
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+
+// Смещения полей записи
+constexpr int kTypeField = 0;
+constexpr int kChecksumField = 4;
+constexpr int kKeyField = 8;
+constexpr int kDurationField = 16;
+constexpr int kElapsedField = 24;
+constexpr int kMonotonicField = 32;
+constexpr int kWallField = 40;
+
+QByteArray header()
+{
+    QByteArray bytes(SessionJournal::kHeaderSize, '\0');
+    std::memcpy(bytes.data(), SessionJournal::kMagic, 4);
+    qToLittleEndian<quint16>(SessionJournal::kVersion, bytes.data() + 4);
+    qToLittleEndian<quint16>(SessionJournal::kRecordSize, bytes.data() + 6);
+    return bytes;
+}
+
+void encode(const SessionJournal::Record &record, char *out)
+{
+    std::memset(out, 0, SessionJournal::kRecordSize);
+    out[kTypeField] = char(record.type);
+    qToLittleEndian<qint64>(record.key, out + kKeyField);
+    qToLittleEndian<qint64>(record.durationMs, out + kDurationField);
+    qToLittleEndian<qint64>(record.elapsedMs, out + kElapsedField);
+    qToLittleEndian<qint64>(record.monotonicMs, out + kMonotonicField);
+    qToLittleEndian<qint64>(record.wallMs, out + kWallField);
+    const quint32 checksum = QuotePack::crc32(reinterpret_cast<const uchar *>(out), SessionJournal::kRecordSize);
+    qToLittleEndian<quint32>(checksum, out + kChecksumField);
+}
+
+bool decode(const char *in, SessionJournal::Record *record)
+{
+    char copy[SessionJournal::kRecordSize];
+    std::memcpy(copy, in, sizeof(copy));
+    const quint32 stored = qFromLittleEndian<quint32>(copy + kChecksumField);
+    std::memset(copy + kChecksumField, 0, 4);
+    if (QuotePack::crc32(reinterpret_cast<const uchar *>(copy), sizeof(copy)) != stored) return false;
+
+    const quint8 type = quint8(copy[kTypeField]);
+    if (type < SessionJournal::Start || type > SessionJournal::Reset) return false;
+    record->type = SessionJournal::RecordType(type);
+    record->key = qFromLittleEndian<qint64>(copy + kKeyField);
+    record->durationMs = qFromLittleEndian<qint64>(copy + kDurationField);
+    record->elapsedMs = qFromLittleEndian<qint64>(copy + kElapsedField);
+    record->monotonicMs = qFromLittleEndian<qint64>(copy + kMonotonicField);
+    record->wallMs = qFromLittleEndian<qint64>(copy + kWallField);
+    return true;
+}
+
+// QFile::flush отдаёт данные ядру, но не носителю: без fsync запись
+// переживает падение процесса, а не отключение питания
+bool syncToDisk(QFile &file)
+{
+#ifdef Q_OS_WIN
+    return _commit(file.handle()) == 0;
+#else
+    return ::fsync(file.handle()) == 0;
+#endif
+}
+
+} // namespace
+
+SessionJournal::SessionJournal(QObject *parent)
+    : QObject(parent)
+    , m_syncTimer(new QTimer(this))
+{
+    // Записи, сделанные за окно таймера, уходят на диск одним fsync
+    m_syncTimer->setSingleShot(true);
+    m_syncTimer->setInterval(kSyncDelayMs);
+    connect(m_syncTimer, &QTimer::timeout, this, &SessionJournal::sync);
+}
+
+SessionJournal::~SessionJournal()
+{
+    sync();
+}
+
+bool SessionJournal::open(const QString &path, qint64 committedKey)
+{
+    Trace::Span span("журнал: проигрывание");
+    m_file.close();
+    m_file.setFileName(path);
+    m_hasActive = false;
+    m_finished.clear();
+    m_recovery = Recovery();
+    m_lastKey = committedKey;
+
+    // Журнал маленький: состояние одной сессии и редкие незаписанные завершения
+    bool needsCompaction = false;
+    QFile existing(path);
+    if (existing.open(QIODevice::ReadOnly)) {
+        const QByteArray bytes = existing.readAll();
+        existing.close();
+
+        qsizetype position = kHeaderSize;
+        if (bytes.size() < kHeaderSize || !bytes.startsWith(header())) {
+            position = 0;
+            needsCompaction = !bytes.isEmpty();
+        }
+        while (position > 0 && position + kRecordSize <= bytes.size()) {
+            Record record;
+            if (!decode(bytes.constData() + position, &record)) break;
+            apply(record);
+            m_lastKey = qMax(m_lastKey, record.key);
+            position += kRecordSize;
+        }
+        if (position > 0 && position < bytes.size()) {
+            m_recovery.discardedBytes = bytes.size() - position;
+            needsCompaction = true;
+        }
+    }
+
+    // Завершения, которые уже дошли до sessions, повторно не записываются
+    const qsizetype before = m_finished.size();
+    m_finished.erase(std::remove_if(m_finished.begin(), m_finished.end(),
+                                    [committedKey](const Record &record) { return record.key <= committedKey; }),
+                     m_finished.end());
+    needsCompaction = needsCompaction || m_finished.size() != before;
+
+    m_recovery.active = m_hasActive;
+    m_recovery.session = m_active;
+    m_recovery.wasRunning = m_hasActive && m_active.type != Pause;
+    m_recovery.finished = m_finished;
+    if (m_recovery.discardedBytes > 0) {
+        qWarning() << "Журнал сессий: отброшен оборванный хвост," << m_recovery.discardedBytes << "байт";
+    }
+
+    if (needsCompaction || !QFile::exists(path)) {
+        if (!compact()) return false;
+    }
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Unbuffered)) {
+        m_lastError = m_file.errorString();
+        qWarning() << "Не удалось открыть журнал сессий:" << path << m_lastError;
+        return false;
+    }
+    return true;
+}
+
+qint64 SessionJournal::start(qint64 durationMs)
+{
+    // Ключ строго растёт, даже если настенные часы перевели назад
+    m_lastKey = qMax(m_lastKey + 1, QDateTime::currentMSecsSinceEpoch());
+    m_hasActive = true;
+    m_active = Record();
+    m_active.key = m_lastKey;
+    m_active.durationMs = durationMs;
+    append(Start, 0);
+    return m_lastKey;
+}
+
+void SessionJournal::pause(qint64 elapsedMs)
+{
+    if (m_hasActive) append(Pause, elapsedMs);
+}
+
+void SessionJournal::resume(qint64 elapsedMs)
+{
+    if (m_hasActive) append(Resume, elapsedMs);
+}
+
+void SessionJournal::checkpoint(qint64 elapsedMs, bool force)
+{
+    if (!m_hasActive) return;
+    if (!force && QElapsedTimer::msecsSinceReference() - m_lastWriteMs < kCheckpointIntervalMs) return;
+    append(Checkpoint, elapsedMs);
+}
+
+qint64 SessionJournal::finish(qint64 elapsedMs)
+{
+    if (!m_hasActive) return 0;
+
+    const qint64 key = m_active.key;
+    append(Finish, elapsedMs);
+    // Завершение — единственное, что нельзя восстановить из соседних записей
+    sync();
+    return key;
+}
+
+void SessionJournal::reset()
+{
+    if (!m_hasActive) return;
+
+    append(Reset, m_active.elapsedMs);
+    // Отменённая сессия больше не нужна, а завершения ждут своего подтверждения
+    if (m_finished.isEmpty()) compact();
+}
+
+void SessionJournal::commit(qint64 key)
+{
+    const auto it = std::find_if(m_finished.begin(), m_finished.end(),
+                                 [key](const Record &record) { return record.key == key; });
+    if (it == m_finished.end()) return;
+    m_finished.erase(it);
+    compact();
+}
+
+bool SessionJournal::sync()
+{
+    m_syncTimer->stop();
+    if (!m_dirty || !m_file.isOpen()) return true;
+
+    Trace::Span span("журнал: fsync");
+    m_dirty = false;
+    if (!syncToDisk(m_file)) {
+        m_lastError = QString::fromLocal8Bit(strerror(errno));
+        qWarning() << "Не удалось сбросить журнал сессий на диск:" << m_lastError;
+        return false;
+    }
+    return true;
+}
+
+void SessionJournal::append(RecordType type, qint64 elapsedMs)
+{
+    Record record = m_active;
+    record.type = type;
+    record.elapsedMs = elapsedMs;
+    record.monotonicMs = QElapsedTimer::msecsSinceReference();
+    record.wallMs = QDateTime::currentMSecsSinceEpoch();
+    apply(record);
+    m_lastWriteMs = record.monotonicMs;
+
+    if (!m_file.isOpen() || !writeRecord(record)) return;
+    m_dirty = true;
+    if (!m_syncTimer->isActive()) m_syncTimer->start();
+}
+
+bool SessionJournal::writeRecord(const Record &record)
+{
+    // Файл открыт без буфера Qt: запись сразу попадает в ядро и переживает kill
+    char bytes[kRecordSize];
+    encode(record, bytes);
+    if (m_file.write(bytes, kRecordSize) != kRecordSize) {
+        m_lastError = m_file.errorString();
+        qWarning() << "Не удалось дописать журнал сессий:" << m_lastError;
+        return false;
+    }
+    return true;
+}
+
+bool SessionJournal::compact()
+{
+    Trace::Span span("журнал: сжатие");
+
+    // Новый файл собирается рядом и подменяет старый атомарно: при падении
+    // посередине на диске остаётся одна из двух целых версий
+    QByteArray bytes = header();
+    auto appendRecord = [&bytes](const Record &record) {
+        char encoded[kRecordSize];
+        encode(record, encoded);
+        bytes.append(encoded, kRecordSize);
+    };
+    for (const Record &record : std::as_const(m_finished)) {
+        appendRecord(record);
+    }
+    if (m_hasActive) appendRecord(m_active);
+
+    const bool wasOpen = m_file.isOpen();
+    m_file.close();
+    m_syncTimer->stop();
+    m_dirty = false;
+
+    // QSaveFile сбрасывает новый файл на диск перед подменой
+    QSaveFile out(m_file.fileName());
+    bool ok = out.open(QIODevice::WriteOnly) && out.write(bytes) == bytes.size() && out.commit();
+    if (!ok) {
+        m_lastError = out.errorString();
+        qWarning() << "Не удалось сжать журнал сессий:" << m_lastError;
+    }
+
+    if (wasOpen && !m_file.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Unbuffered)) {
+        m_lastError = m_file.errorString();
+        qWarning() << "Не удалось открыть журнал сессий:" << m_lastError;
+        ok = false;
+    }
+    return ok;
+}
+
+void SessionJournal::apply(const Record &record)
+{
+    switch (record.type) {
+    case Start:
+    case Pause:
+    case Resume:
+    case Checkpoint:
+        m_active = record;
+        m_hasActive = true;
+        break;
+    case Finish:
+        m_finished.append(record);
+        if (m_hasActive && m_active.key == record.key) m_hasActive = false;
+        break;
+    case Reset:
+        if (m_hasActive && m_active.key == record.key) m_hasActive = false;
+        break;
+    }
+}
@@ -0,0 +1,310 @@
+#include "../headers/sessiontransfer.h"
+#include "../headers/progressrepository.h"
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QIODevice>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRegularExpression>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QVariant>
+#include <QVector>
+#include <utility>
+
+namespace {
+
+constexpr int    kRowsPerStatement = 250;        // 750 параметров: ниже старого лимита SQLite в 999
+constexpr qint64 kRowsPerTransaction = 50000;    // Реже fsync, но транзакция не растёт бесконечно
+constexpr int    kWriteBufferSize = 64 * 1024;
+
+// Так start_time хранит SQLite (CURRENT_TIMESTAMP, UTC) и так его выгружает экспорт
+const char kStartTimeFormat[] = "yyyy-MM-dd HH:mm:ss";
+
+struct ImportRow {
+    qint64  id = 0;   // 0 — в файле номера нет
+    QString startTime;
+    int     duration = 0;
+};
+
+// Многострочный INSERT на rows записей, параметры идут тройками (id, start_time, duration).
+// Номер из файла сохраняется, если свободен. Сессия, которая уже лежит в базе под
+// тем же номером с теми же данными, — дубликат и пропускается, поэтому повторный
+// импорт того же файла ничего не добавляет. Занятый другой сессией номер и
+// отсутствующий номер заменяются новым
+QString batchInsertSql(int rows)
+{
+    QString sql = "WITH v(id, start_time, duration_minutes) AS (VALUES ";
+    sql.reserve(sql.size() + rows * 8 + 320);
+    for (int i = 0; i < rows; ++i) {
+        sql += (i == 0) ? "(?,?,?)" : ",(?,?,?)";
+    }
+    sql += ") INSERT OR IGNORE INTO sessions (id, start_time, duration_minutes)"
+           " SELECT CASE WHEN s.id IS NULL THEN v.id END, v.start_time, v.duration_minutes"
+           " FROM v LEFT JOIN sessions s ON s.id = v.id"
+           " WHERE s.id IS NULL OR s.start_time IS NOT v.start_time"
+           " OR s.duration_minutes IS NOT v.duration_minutes";
+    return sql;
+}
+
+QVariant idValue(qint64 id)
+{
+    return id > 0 ? QVariant(id) : QVariant(QMetaType(QMetaType::LongLong));
+}
+
+void appendJsonString(QByteArray &out, const QByteArray &value)
+{
+    out += '"';
+    for (char c : value) {
+        if (c == '"' || c == '\\') out += '\\';
+        out += c;
+    }
+    out += '"';
+}
+
+QByteArray unquote(const QByteArray &field)
+{
+    const QByteArray trimmed = field.trimmed();
+    if (trimmed.size() >= 2 && trimmed.startsWith('"') && trimmed.endsWith('"')) {
+        return trimmed.mid(1, trimmed.size() - 2);
+    }
+    return trimmed;
+}
+
+// Время сессии в формате базы, в UTC. Строка, которую не удалось разобрать, в sessions
+// не попадает: триггеры свёрток получили бы из неё NULL вместо дня, недели и месяца.
+// Время со смещением или Z переводится в UTC. Время без пояса считается уже UTC:
+// так его выгружает экспорт, и повторный импорт выгрузки не сдвигает сессии
+bool normalizeStartTime(QString *startTime)
+{
+    static const QRegularExpression zoneSuffix("(Z|[+-]\\d{2}(:?\\d{2})?)$");
+
+    QString iso = startTime->trimmed();
+    if (iso.size() < 16) return false;   // Нужны и дата, и время
+    if (iso.at(10) == ' ') iso[10] = 'T';   // Формат экспорта
+    if (iso.at(10) != 'T') return false;
+    // Без пояса QDateTime прочитал бы местное время; явный Z фиксирует UTC
+    if (!zoneSuffix.match(iso).hasMatch()) iso += 'Z';
+
+    const QDateTime time = QDateTime::fromString(iso, Qt::ISODate);
+    if (!time.isValid()) return false;
+    *startTime = time.toUTC().toString(kStartTimeFormat);
+    return true;
+}
+
+// Принимает строки «id,start_time,duration_minutes» и «start_time,duration_minutes»
+bool parseCsvLine(const QByteArray &line, ImportRow *row)
+{
+    const QList<QByteArray> fields = line.split(',');
+    if (fields.size() != 2 && fields.size() != 3) return false;
+
+    bool ok = true;
+    row->id = (fields.size() == 3) ? unquote(fields.first()).toLongLong(&ok) : 0;
+    if (!ok || row->id < 0) return false;
+    row->startTime = QString::fromUtf8(unquote(fields.at(fields.size() - 2)));
+    row->duration = unquote(fields.last()).toInt(&ok);
+    return ok && row->duration > 0 && normalizeStartTime(&row->startTime);
+}
+
+bool parseNdJsonLine(const QByteArray &line, ImportRow *row)
+{
+    const QJsonDocument document = QJsonDocument::fromJson(line);
+    if (!document.isObject()) return false;
+
+    const QJsonObject object = document.object();
+    row->id = object.value("id").toInteger();
+    if (row->id < 0) return false;
+    row->startTime = object.value("start_time").toString();
+    row->duration = object.value("duration_minutes").toInt();
+    return row->duration > 0 && normalizeStartTime(&row->startTime);
+}
+
+} // namespace
+
+SessionTransfer::Format SessionTransfer::formatForPath(const QString &path)
+{
+    const QString suffix = QFileInfo(path).suffix().toLower();
+    return (suffix == "ndjson" || suffix == "jsonl") ? Format::NdJson : Format::Csv;
+}
+
+SessionTransfer::SessionTransfer(ProgressRepository *repository)
+    : m_repository(repository)
+{
+}
+
+bool SessionTransfer::exportTo(QIODevice *out, Format format, TransferStats *stats)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    // forward-only: SQLite отдаёт строки по одной, результат не копится в памяти
+    QSqlQuery query(m_repository->database());
+    query.setForwardOnly(true);
+    if (!query.exec("SELECT id, start_time, duration_minutes FROM sessions ORDER BY id")) {
+        m_lastError = query.lastError().text();
+        return false;
+    }
+
+    QByteArray buffer;
+    buffer.reserve(kWriteBufferSize + 256);
+    if (format == Format::Csv) {
+        buffer += "id,start_time,duration_minutes\n";
+    }
+
+    qint64 rows = 0;
+    while (query.next()) {
+        const QByteArray id = QByteArray::number(query.value(0).toLongLong());
+        const QByteArray startTime = query.value(1).toString().toUtf8();
+        const QByteArray duration = QByteArray::number(query.value(2).toInt());
+
+        if (format == Format::Csv) {
+            buffer += id;
+            buffer += ',';
+            buffer += startTime;
+            buffer += ',';
+            buffer += duration;
+            buffer += '\n';
+        } else {
+            buffer += "{\"id\":";
+            buffer += id;
+            buffer += ",\"start_time\":";
+            appendJsonString(buffer, startTime);
+            buffer += ",\"duration_minutes\":";
+            buffer += duration;
+            buffer += "}\n";
+        }
+        rows++;
+
+        if (buffer.size() >= kWriteBufferSize) {
+            if (out->write(buffer) != buffer.size()) {
+                m_lastError = out->errorString();
+                return false;
+            }
+            buffer.clear();
+        }
+    }
+
+    if (!buffer.isEmpty() && out->write(buffer) != buffer.size()) {
+        m_lastError = out->errorString();
+        return false;
+    }
+
+    if (stats) {
+        stats->rows = rows;
+        stats->skipped = 0;
+        stats->elapsedMs = timer.elapsed();
+    }
+    return true;
+}
+
+bool SessionTransfer::importFrom(QIODevice *in, Format format, TransferStats *stats)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    QSqlDatabase db = m_repository->database();
+    QSqlQuery batchInsert(db);
+    QSqlQuery singleInsert(db);
+    if (!batchInsert.prepare(batchInsertSql(kRowsPerStatement))
+        || !singleInsert.prepare(batchInsertSql(1))) {
+        m_lastError = batchInsert.lastError().text();
+        return false;
+    }
+
+    QVector<ImportRow> pending;
+    pending.reserve(kRowsPerStatement);
+    qint64 rows = 0;
+    qint64 skipped = 0;
+    qint64 duplicates = 0;
+    qint64 rowsInTransaction = 0;
+    qint64 committedRows = 0;   // Уже зафиксировано в базе прошлыми транзакциями
+
+    const auto reportStats = [&]() {
+        if (stats) {
+            stats->rows = rows;
+            stats->skipped = skipped;
+            stats->duplicates = duplicates;
+            stats->elapsedMs = timer.elapsed();
+        }
+    };
+
+    // Откатывается только текущая транзакция: всё, что зафиксировано раньше,
+    // остаётся в базе и попадает в stats->rows, а повторный запуск пропустит
+    // эти строки как дубликаты
+    const auto fail = [&](const QString &error) {
+        db.rollback();
+        rows = committedRows;
+        reportStats();
+        m_lastError = committedRows > 0
+            ? QString("%1 (уже записано %2 строк; повторный импорт того же файла их пропустит)")
+                  .arg(error).arg(committedRows)
+            : error;
+        return false;
+    };
+
+    // Пачка уходит одним подготовленным многострочным INSERT; дубликаты он пропускает
+    const auto flush = [&](QSqlQuery &insert) {
+        for (int i = 0; i < pending.size(); ++i) {
+            const ImportRow &row = pending.at(i);
+            insert.bindValue(3 * i, idValue(row.id));
+            insert.bindValue(3 * i + 1, row.startTime);
+            insert.bindValue(3 * i + 2, row.duration);
+        }
+        if (!insert.exec()) return false;
+        const int inserted = insert.numRowsAffected();
+        rows += inserted;
+        rowsInTransaction += inserted;
+        duplicates += pending.size() - inserted;
+        pending.clear();
+        return true;
+    };
+
+    if (!db.transaction()) {
+        m_lastError = db.lastError().text();
+        return false;
+    }
+
+    bool firstLine = true;
+    while (!in->atEnd()) {
+        const QByteArray line = in->readLine().trimmed();
+        if (line.isEmpty()) continue;
+
+        ImportRow row;
+        const bool parsed = (format == Format::Csv) ? parseCsvLine(line, &row)
+                                                    : parseNdJsonLine(line, &row);
+        if (!parsed) {
+            // Первая строка CSV — обычно заголовок, это не ошибка
+            if (!(firstLine && format == Format::Csv)) skipped++;
+            firstLine = false;
+            continue;
+        }
+        firstLine = false;
+
+        pending.append(row);
+        if (pending.size() == kRowsPerStatement && !flush(batchInsert)) {
+            return fail(batchInsert.lastError().text());
+        }
+
+        if (rowsInTransaction >= kRowsPerTransaction) {
+            if (!db.commit()) return fail(db.lastError().text());
+            committedRows = rows;
+            if (!db.transaction()) return fail(db.lastError().text());
+            rowsInTransaction = 0;
+        }
+    }
+
+    // Хвост меньше целой пачки вставляем по одной записи тем же способом
+    const QVector<ImportRow> tail = std::exchange(pending, {});
+    for (const ImportRow &row : tail) {
+        pending = {row};
+        if (!flush(singleInsert)) return fail(singleInsert.lastError().text());
+    }
+
+    batchInsert.finish();
+    singleInsert.finish();
+    if (!db.commit()) return fail(db.lastError().text());
+
+    reportStats();
+    return true;
+}
@@ -0,0 +1,87 @@
+#include "../headers/settingsstore.h"
+#include "../headers/persistenceworker.h"
+#include <QTimer>
+#include <QDebug>
+
+SettingsStore::SettingsStore(PersistenceWorker *writer, const QString &profile, QObject *parent)
+    : QObject(parent)
+    , m_writer(writer)
+    , m_profile(profile)
+    , m_flushTimer(new QTimer(this))
+{
+    // Каждое изменение перезапускает таймер, поэтому запись происходит
+    // только после kQuietPeriodMs без новых изменений
+    m_flushTimer->setSingleShot(true);
+    m_flushTimer->setInterval(kQuietPeriodMs);
+    connect(m_flushTimer, &QTimer::timeout, this, &SettingsStore::flush);
+}
+
+SettingsStore::~SettingsStore()
+{
+    flush();
+    qInfo().noquote() << QString("Настройки: сохранений %1, транзакций %2, сэкономлено %3")
+                             .arg(m_saveRequests)
+                             .arg(m_transactions)
+                             .arg(writesAvoided());
+}
+
+void SettingsStore::setProfile(const QString &profile)
+{
+    if (profile == m_profile) return;
+    flush();
+    m_values.clear();
+    m_profile = profile;
+}
+
+void SettingsStore::load(const QString &key, const QString &value)
+{
+    m_values.insert(key, value);
+}
+
+QString SettingsStore::value(const QString &key, const QString &defaultValue) const
+{
+    return m_values.value(key, defaultValue);
+}
+
+void SettingsStore::setValue(const QString &key, const QString &value)
+{
+    setValues({{key, value}});
+}
+
+void SettingsStore::setValues(const QList<QPair<QString, QString>> &values)
+{
+    // Каждое сохранение считается один раз, сколько бы ключей в нём ни было.
+    // Сэкономлено столько сохранений, сколько не превратилось в свою транзакцию:
+    // не изменившие ничего и слившиеся в одну пачку с соседними
+    m_saveRequests++;
+
+    bool changed = false;
+    for (const auto &entry : values) {
+        // Значение не изменилось, так что и записывать нечего
+        auto it = m_values.find(entry.first);
+        if (it != m_values.end() && it.value() == entry.second) continue;
+        m_values.insert(entry.first, entry.second);
+        m_dirty.insert(entry.first);
+        changed = true;
+    }
+    if (changed) m_flushTimer->start();
+}
+
+void SettingsStore::flush()
+{
+    m_flushTimer->stop();
+    if (m_dirty.isEmpty()) return;
+
+    // Раньше каждое сохранение было отдельной транзакцией, теперь все они сливаются в одну
+    if (m_writer) {
+        m_transactions++;
+        WriteCommand command;
+        command.type = WriteCommand::SaveSettings;
+        command.profile = m_profile;
+        for (const QString &key : std::as_const(m_dirty)) {
+            command.settings.append({key, m_values.value(key)});
+        }
+        m_writer->enqueue(command);
+    }
+    m_dirty.clear();
+}
@@ -0,0 +1,62 @@
+#include "../headers/startuptrace.h"
+#include <QThread>
+#include <algorithm>
+
+StartupTrace::Scope::Scope(StartupTrace &trace, const char *stage)
+    : m_trace(trace)
+    , m_stage(stage)
+    , m_beginNs(trace.elapsedNs())
+    , m_span(stage)
+{
+}
+
+StartupTrace::Scope::~Scope()
+{
+    m_trace.record(m_stage, m_beginNs, m_trace.elapsedNs());
+}
+
+StartupTrace::StartupTrace()
+    : m_mainThread(QThread::currentThreadId())
+{
+    m_clock.start();
+}
+
+void StartupTrace::record(const char *stage, qint64 beginNs, qint64 endNs)
+{
+    const bool mainThread = QThread::currentThreadId() == m_mainThread;
+    QMutexLocker locker(&m_mutex);
+    m_entries.append({QByteArray(stage), beginNs, endNs, mainThread});
+}
+
+void StartupTrace::mark(const char *stage)
+{
+    const qint64 now = elapsedNs();
+    record(stage, now, now);
+    Trace::instant(stage);
+}
+
+QString StartupTrace::report() const
+{
+    QVector<Entry> entries;
+    {
+        QMutexLocker locker(&m_mutex);
+        entries = m_entries;
+    }
+    std::stable_sort(entries.begin(), entries.end(), [](const Entry &a, const Entry &b) {
+        return a.beginNs < b.beginNs;
+    });
+
+    // Миллисекунды с одним знаком после запятой: этапы запуска короткие
+    const auto ms = [](qint64 ns) { return QString::number(ns / 1e6, 'f', 1); };
+
+    QString text = "Этапы запуска (мс от старта):";
+    for (const Entry &entry : std::as_const(entries)) {
+        text += QString("\n  %1 %2 .. %3  (%4)  [%5]")
+                    .arg(QString::fromUtf8(entry.stage), -24)
+                    .arg(ms(entry.beginNs), 7)
+                    .arg(ms(entry.endNs), 7)
+                    .arg(ms(entry.endNs - entry.beginNs), 6)
+                    .arg(entry.mainThread ? "главный поток" : "фоновый поток");
+    }
+    return text;
+}
@@ -0,0 +1,133 @@
+#include "../headers/statsdialog.h"
+#include "../headers/progressrepository.h"
+#include "../headers/theme.h"
+#include "../headers/trace.h"
+#include <QComboBox>
+#include <QFont>
+#include <QFormLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QLocale>
+#include <QPushButton>
+#include <QTableWidget>
+#include <QVBoxLayout>
+
+namespace {
+
+// Сколько последних периодов показывать в таблице
+constexpr int kDaysShown = 30;
+constexpr int kWeeksShown = 12;
+constexpr int kMonthsShown = 12;
+
+} // namespace
+
+StatsDialog::StatsDialog(ProgressRepository *repository, QWidget *parent)
+    : QDialog(parent)
+    , m_repository(repository)
+{
+    Trace::Span span("создание статистики");
+    setWindowTitle("Статистика 📈");
+    setMinimumSize(420, 480);
+    setupUI();
+    loadSummary();
+    updateTable();
+}
+
+void StatsDialog::setupUI()
+{
+    auto *mainLayout = new QVBoxLayout(this);
+    mainLayout->setSpacing(12);
+    mainLayout->setContentsMargins(15, 15, 15, 15);
+
+    // Сводка по основным диапазонам и сериям
+    m_summaryLabel = new QLabel(this);
+    m_summaryLabel->setFont(QFont("Sans", 12));
+    m_summaryLabel->setMargin(8);
+    m_summaryLabel->setAutoFillBackground(true);
+    m_summaryLabel->setPalette(Theme::current().infoPalette());
+
+    m_periodComboBox = new QComboBox(this);
+    m_periodComboBox->addItem("По дням", int(StatsPeriod::Day));
+    m_periodComboBox->addItem("По неделям", int(StatsPeriod::Week));
+    m_periodComboBox->addItem("По месяцам", int(StatsPeriod::Month));
+    connect(m_periodComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &StatsDialog::updateTable);
+
+    auto *periodLayout = new QFormLayout();
+    periodLayout->addRow("Группировка:", m_periodComboBox);
+
+    m_table = new QTableWidget(0, 3, this);
+    m_table->setHorizontalHeaderLabels({"Период", "Сессий", "Минут"});
+    m_table->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    m_table->verticalHeader()->setVisible(false);
+    m_table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_table->setSelectionMode(QAbstractItemView::NoSelection);
+
+    auto *closeButton = new QPushButton("Закрыть", this);
+    closeButton->setMinimumHeight(36);
+    connect(closeButton, &QPushButton::clicked, this, &QDialog::accept);
+
+    mainLayout->addWidget(m_summaryLabel);
+    mainLayout->addLayout(periodLayout);
+    mainLayout->addWidget(m_table, 1);
+    mainLayout->addWidget(closeButton);
+}
+
+void StatsDialog::loadSummary()
+{
+    const QDate today = QDate::currentDate();
+    const QDate weekStart = today.addDays(1 - today.dayOfWeek());
+    const QDate monthStart(today.year(), today.month(), 1);
+
+    const StatsRow day = m_repository->statsTotal(today, today);
+    const StatsRow week = m_repository->statsTotal(weekStart, today);
+    const StatsRow month = m_repository->statsTotal(monthStart, today);
+    const StatsRow all = m_repository->statsTotal(QDate(1970, 1, 1), today);
+    const StatsStreaks streaks = m_repository->streaks(today);
+
+    const auto line = [](const QString &title, const StatsRow &row) {
+        return QString("%1: %2 сесс., %3 мин.").arg(title).arg(row.sessions).arg(row.minutes);
+    };
+
+    m_summaryLabel->setText(QStringList{
+        line("Сегодня", day),
+        line("Эта неделя", week),
+        line("Этот месяц", month),
+        line("Всего", all),
+        QString("🔥 Серия: %1 дн. подряд (лучшая: %2)").arg(streaks.current).arg(streaks.longest)
+    }.join('\n'));
+}
+
+void StatsDialog::updateTable()
+{
+    const auto period = StatsPeriod(m_periodComboBox->currentData().toInt());
+    const QDate today = QDate::currentDate();
+
+    QDate from;
+    QString format;
+    switch (period) {
+    case StatsPeriod::Day:
+        from = today.addDays(1 - kDaysShown);
+        format = "dd.MM.yyyy";
+        break;
+    case StatsPeriod::Week:
+        from = today.addDays(1 - today.dayOfWeek()).addDays(-7 * (kWeeksShown - 1));
+        format = "'с' dd.MM.yyyy";
+        break;
+    case StatsPeriod::Month:
+        from = QDate(today.year(), today.month(), 1).addMonths(1 - kMonthsShown);
+        format = "LLLL yyyy";
+        break;
+    }
+
+    const QList<StatsRow> rows = m_repository->statsRows(period, from, today);
+    const QLocale locale;
+
+    m_table->setRowCount(int(rows.size()));
+    for (int i = 0; i < rows.size(); ++i) {
+        const StatsRow &row = rows.at(i);
+        m_table->setItem(i, 0, new QTableWidgetItem(locale.toString(row.periodStart, format)));
+        m_table->setItem(i, 1, new QTableWidgetItem(QString::number(row.sessions)));
+        m_table->setItem(i, 2, new QTableWidgetItem(QString::number(row.minutes)));
+    }
+}
@@ -0,0 +1,151 @@
+#include "../headers/theme.h"
+#include "../headers/trace.h"
+#include <QApplication>
+#include <QToolTip>
+
+namespace {
+
+const Theme *g_current = nullptr;
+
+// Палитра, в которой явно задана только одна роль
+QPalette singleRole(QPalette::ColorRole role, const QColor &color)
+{
+    QPalette palette;
+    palette.setColor(role, color);
+    return palette;
+}
+
+} // namespace
+
+const Theme &Theme::light()
+{
+    static const Theme theme = makeLight();
+    return theme;
+}
+
+const Theme &Theme::dark()
+{
+    static const Theme theme = makeDark();
+    return theme;
+}
+
+const Theme &Theme::byName(const QString &name)
+{
+    return name == QLatin1String("dark") ? dark() : light();
+}
+
+const Theme &Theme::current()
+{
+    return g_current ? *g_current : light();
+}
+
+void Theme::apply(const Theme &theme)
+{
+    if (g_current == &theme) return;
+    g_current = &theme;
+    Trace::Span span("палитра приложения");
+
+    // Смена палитры рассылает виджетам только PaletteChange: стиль и метрики не пересчитываются
+    QApplication::setPalette(theme.palette());
+    QToolTip::setPalette(theme.palette());
+}
+
+QFont Theme::timeFont()
+{
+    QFont font;
+    font.setPixelSize(72);
+    font.setBold(true);
+    return font;
+}
+
+QFont Theme::counterFont()
+{
+    QFont font;
+    font.setPixelSize(18);
+    return font;
+}
+
+QFont Theme::quoteFont()
+{
+    QFont font;
+    font.setPixelSize(16);
+    font.setItalic(true);
+    return font;
+}
+
+Theme Theme::makeLight()
+{
+    // В светлой теме светло-серый фон и тёмный текст
+    Theme theme;
+    theme.m_name = "light";
+    theme.m_dark = false;
+
+    QPalette &palette = theme.m_palette;
+    palette.setColor(QPalette::Window, QColor(245, 247, 250));
+    palette.setColor(QPalette::WindowText, QColor(44, 62, 80));
+    palette.setColor(QPalette::Base, Qt::white);
+    palette.setColor(QPalette::AlternateBase, QColor(240, 240, 240));
+    palette.setColor(QPalette::ToolTipBase, Qt::white);
+    palette.setColor(QPalette::ToolTipText, Qt::black);
+    palette.setColor(QPalette::Text, QColor(44, 62, 80));
+    palette.setColor(QPalette::PlaceholderText, QColor(149, 165, 166));
+    palette.setColor(QPalette::Button, QColor(230, 230, 230));
+    palette.setColor(QPalette::ButtonText, QColor(44, 62, 80));
+    palette.setColor(QPalette::BrightText, Qt::red);
+    palette.setColor(QPalette::Mid, QColor(221, 221, 221));
+    palette.setColor(QPalette::Highlight, QColor(52, 152, 219));
+    palette.setColor(QPalette::HighlightedText, Qt::white);
+
+    theme.buildRolePalettes(QColor(44, 62, 80), QColor(52, 152, 219), QColor(127, 140, 141),
+                            QColor(41, 128, 185), QColor(227, 242, 253));
+
+    theme.m_revealText = QColor(230, 126, 34);
+    theme.m_revealBackground = QColor(255, 243, 205);
+    theme.m_highlightText = QColor(39, 174, 96);
+    theme.m_highlightBackground = QColor(232, 245, 233);
+    return theme;
+}
+
+Theme Theme::makeDark()
+{
+    // В тёмной теме тёмно-серый фон и светлый текст
+    Theme theme;
+    theme.m_name = "dark";
+    theme.m_dark = true;
+
+    QPalette &palette = theme.m_palette;
+    palette.setColor(QPalette::Window, QColor(53, 53, 53));
+    palette.setColor(QPalette::WindowText, Qt::white);
+    palette.setColor(QPalette::Base, QColor(35, 35, 35));
+    palette.setColor(QPalette::AlternateBase, QColor(53, 53, 53));
+    palette.setColor(QPalette::ToolTipBase, QColor(42, 42, 42));
+    palette.setColor(QPalette::ToolTipText, Qt::white);
+    palette.setColor(QPalette::Text, Qt::white);
+    palette.setColor(QPalette::PlaceholderText, QColor(120, 130, 135));
+    palette.setColor(QPalette::Button, QColor(70, 70, 70));
+    palette.setColor(QPalette::ButtonText, Qt::white);
+    palette.setColor(QPalette::BrightText, Qt::red);
+    palette.setColor(QPalette::Mid, QColor(70, 70, 70));
+    palette.setColor(QPalette::Highlight, QColor(42, 130, 218));
+    palette.setColor(QPalette::HighlightedText, Qt::black);
+
+    theme.buildRolePalettes(QColor(79, 195, 247), QColor(100, 181, 246), QColor(176, 190, 197),
+                            QColor(100, 181, 246), QColor(42, 59, 77));
+
+    theme.m_revealText = QColor(230, 126, 34);
+    theme.m_revealBackground = QColor(77, 63, 30);
+    theme.m_highlightText = QColor(100, 181, 246);
+    theme.m_highlightBackground = QColor(42, 59, 77);
+    return theme;
+}
+
+void Theme::buildRolePalettes(const QColor &time, const QColor &counter, const QColor &quote,
+                              const QColor &infoText, const QColor &infoBackground)
+{
+    m_timePalette = singleRole(QPalette::WindowText, time);
+    m_counterPalette = singleRole(QPalette::WindowText, counter);
+    m_quotePalette = singleRole(QPalette::WindowText, quote);
+
+    m_infoPalette = singleRole(QPalette::WindowText, infoText);
+    m_infoPalette.setColor(QPalette::Window, infoBackground);
+}
@@ -0,0 +1,198 @@
+#include "../headers/timerdaemon.h"
+#include "../headers/timerengine.h"
+#include "../headers/persistenceworker.h"
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QDebug>
+
+namespace {
+
+constexpr int kMinMinutes = 1;
+constexpr int kMaxMinutes = 600;
+constexpr int kProbeTimeoutMs = 500;   // Живой демон принимает подключение сразу
+
+} // namespace
+
+TimerDaemon::TimerDaemon(int defaultMinutes, PersistenceWorker *writer, const QString &profile, QObject *parent)
+    : QObject(parent)
+    , m_server(new QLocalServer(this))
+    , m_engine(new TimerEngine(this))
+    , m_writer(writer)
+    , m_profile(profile)
+    , m_minutes(qBound(kMinMinutes, defaultMinutes, kMaxMinutes))
+{
+    m_engine->setDuration(qint64(m_minutes) * 60 * 1000);
+    updateWakeInterval();
+
+    connect(m_server, &QLocalServer::newConnection, this, &TimerDaemon::onNewConnection);
+    connect(m_engine, &TimerEngine::ticked, this, &TimerDaemon::onTicked);
+    connect(m_engine, &TimerEngine::finished, this, &TimerDaemon::onFinished);
+}
+
+bool TimerDaemon::listen(const QString &serverName)
+{
+    m_listenError.clear();
+
+    // Если по имени кто-то отвечает, это уже запущенный таймер: его сокет не трогаем
+    QLocalSocket probe;
+    probe.connectToServer(serverName);
+    if (probe.waitForConnected(kProbeTimeoutMs)) {
+        probe.disconnectFromServer();
+        m_listenError = QString("Сокет %1 уже обслуживает другой запущенный таймер").arg(serverName);
+        return false;
+    }
+    // Файл сокета есть, но подключение отклонено — он остался от аварийно
+    // завершённого процесса. Занятый или недоступный сокет не удаляем
+    if (probe.error() == QLocalSocket::ConnectionRefusedError) {
+        QLocalServer::removeServer(serverName);
+    }
+
+    // Управлять таймером может только владелец процесса
+    m_server->setSocketOptions(QLocalServer::UserAccessOption);
+    return m_server->listen(serverName);
+}
+
+QString TimerDaemon::errorString() const
+{
+    return m_listenError.isEmpty() ? m_server->errorString() : m_listenError;
+}
+
+void TimerDaemon::onNewConnection()
+{
+    while (QLocalSocket *client = m_server->nextPendingConnection()) {
+        connect(client, &QLocalSocket::readyRead, this, &TimerDaemon::onReadyRead);
+        connect(client, &QLocalSocket::disconnected, this, &TimerDaemon::onDisconnected);
+    }
+}
+
+void TimerDaemon::onReadyRead()
+{
+    auto *client = qobject_cast<QLocalSocket *>(sender());
+    if (!client) return;
+
+    // Отвечаем на все целиком пришедшие строки и сразу выталкиваем ответ в сокет
+    bool replied = false;
+    while (client->canReadLine()) {
+        const QByteArray line = client->readLine().trimmed();
+        if (line.isEmpty()) continue;
+        client->write(handleCommand(client, line));
+        replied = true;
+    }
+    if (replied) {
+        client->flush();
+    }
+}
+
+void TimerDaemon::onDisconnected()
+{
+    auto *client = qobject_cast<QLocalSocket *>(sender());
+    if (!client) return;
+
+    m_subscribers.remove(client);
+    updateWakeInterval();
+    client->deleteLater();
+}
+
+void TimerDaemon::onTicked(int remainingSeconds)
+{
+    if (m_engine->isRunning()) {
+        broadcast("tick " + QByteArray::number(remainingSeconds) + '\n');
+    }
+}
+
+void TimerDaemon::onFinished()
+{
+    if (m_writer) {
+        // В отличие от окна, цитату сессия не открывает: у демона нет хранилища
+        // цитат, а порядок открытия знает только окно. unlocksQuote остаётся false,
+        // и сессия просто учитывается в счётчике и статистике профиля
+        WriteCommand command;
+        command.type = WriteCommand::RecordSession;
+        command.profile = m_profile;
+        command.durationMinutes = m_minutes;
+        m_writer->enqueue(command);
+    }
+
+    broadcast("finished\n");
+    // Как и в окне, после завершения таймер готов к следующему кругу
+    m_engine->setDuration(qint64(m_minutes) * 60 * 1000);
+}
+
+QByteArray TimerDaemon::handleCommand(QLocalSocket *client, const QByteArray &line)
+{
+    const QList<QByteArray> parts = line.split(' ');
+    const QByteArray &command = parts.first();
+
+    // Необязательный аргумент «минуты» у start и reset
+    int minutes = 0;
+    if (parts.size() > 1) {
+        bool ok = false;
+        minutes = parts.at(1).toInt(&ok);
+        if (!ok || minutes < kMinMinutes || minutes > kMaxMinutes) {
+            return "err bad-minutes\n";
+        }
+    }
+
+    if (command == "status") {
+        return "ok " + stateLine() + ' ' + QByteArray::number(m_engine->durationMs()) + '\n';
+    }
+    if (command == "start") {
+        // Новая длительность применяется, только если таймер не идёт и не на паузе
+        if (minutes > 0 && !m_engine->isRunning()
+            && m_engine->remainingMs() == m_engine->durationMs()) {
+            setMinutes(minutes);
+        }
+        m_engine->start();
+        return "ok " + stateLine() + '\n';
+    }
+    if (command == "pause") {
+        m_engine->pause();
+        return "ok " + stateLine() + '\n';
+    }
+    if (command == "reset") {
+        setMinutes(minutes > 0 ? minutes : m_minutes);
+        return "ok " + stateLine() + '\n';
+    }
+    if (command == "subscribe") {
+        m_subscribers.insert(client);
+        updateWakeInterval();
+        return "ok subscribed\n";
+    }
+    if (command == "unsubscribe") {
+        m_subscribers.remove(client);
+        updateWakeInterval();
+        return "ok unsubscribed\n";
+    }
+    return "err unknown-command\n";
+}
+
+QByteArray TimerDaemon::stateLine() const
+{
+    const qint64 remaining = m_engine->remainingMs();
+    QByteArray state = "idle";
+    if (m_engine->isRunning()) {
+        state = "running";
+    } else if (remaining > 0 && remaining < m_engine->durationMs()) {
+        state = "paused";
+    }
+    return state + ' ' + QByteArray::number(remaining);
+}
+
+void TimerDaemon::setMinutes(int minutes)
+{
+    m_minutes = minutes;
+    m_engine->setDuration(qint64(m_minutes) * 60 * 1000);
+}
+
+void TimerDaemon::broadcast(const QByteArray &event)
+{
+    for (QLocalSocket *subscriber : std::as_const(m_subscribers)) {
+        subscriber->write(event);
+        subscriber->flush();
+    }
+}
+
+void TimerDaemon::updateWakeInterval()
+{
+    m_engine->setWakeInterval(m_subscribers.isEmpty() ? 0 : TimerEngine::kTickMs);
+}
@@ -0,0 +1,119 @@
+#include "../headers/timerengine.h"
+#include <QTimer>
+
+TimerEngine::TimerEngine(QObject *parent)
+    : QObject(parent)
+    , m_timer(new QTimer(this))
+{
+    // Однократный точный таймер: после каждого срабатывания он перезаводится
+    // заново, поэтому ошибка одного тика не переносится на следующий
+    m_timer->setSingleShot(true);
+    m_timer->setTimerType(Qt::PreciseTimer);
+    connect(m_timer, &QTimer::timeout, this, &TimerEngine::onTimeout);
+}
+
+void TimerEngine::setDuration(qint64 durationMs)
+{
+    if (m_running) m_activeMs += m_clock.elapsed();
+    m_timer->stop();
+    m_running = false;
+    m_durationMs = qMax<qint64>(0, durationMs);
+    m_bankedMs = 0;
+}
+
+void TimerEngine::start()
+{
+    if (m_running) return;
+
+    // Если время уже вышло, то начинаем заново с полной длительности
+    if (remainingMs() <= 0) {
+        m_bankedMs = 0;
+    }
+    m_clock.start();
+    m_running = true;
+    arm();
+}
+
+void TimerEngine::pause()
+{
+    if (!m_running) return;
+
+    const qint64 worked = m_clock.elapsed();
+    m_bankedMs += worked;
+    m_activeMs += worked;
+    m_running = false;
+    m_timer->stop();
+}
+
+void TimerEngine::reset()
+{
+    setDuration(m_durationMs);
+}
+
+void TimerEngine::restore(qint64 durationMs, qint64 elapsedMs)
+{
+    // Продолжение после перезапуска: отработанное до него время считается банком паузы
+    setDuration(durationMs);
+    m_bankedMs = qBound<qint64>(0, elapsedMs, m_durationMs);
+}
+
+qint64 TimerEngine::elapsedMs() const
+{
+    return m_bankedMs + (m_running ? m_clock.elapsed() : 0);
+}
+
+qint64 TimerEngine::activeMs() const
+{
+    return m_activeMs + (m_running ? m_clock.elapsed() : 0);
+}
+
+qint64 TimerEngine::remainingMs() const
+{
+    return qMax<qint64>(0, m_durationMs - elapsedMs());
+}
+
+int TimerEngine::remainingSeconds() const
+{
+    return int((remainingMs() + 999) / 1000);
+}
+
+void TimerEngine::setWakeInterval(qint64 intervalMs)
+{
+    intervalMs = qMax<qint64>(0, intervalMs);
+    if (intervalMs == m_wakeIntervalMs) return;
+    m_wakeIntervalMs = intervalMs;
+    if (m_running) arm();
+}
+
+void TimerEngine::arm()
+{
+    const qint64 remaining = remainingMs();
+    qint64 delay = remaining;
+    if (m_wakeIntervalMs > 0 && m_wakeIntervalMs <= kTickMs) {
+        // До следующей смены секунды на экране осталось remaining % 1000 мс
+        delay = remaining % kTickMs;
+        if (delay == 0) delay = kTickMs;
+    } else if (m_wakeIntervalMs > 0) {
+        delay = qMin(remaining, m_wakeIntervalMs);
+    }
+    // Дедлайн не откладывается никаким интервалом, поэтому сессия кончается вовремя
+    m_timer->start(int(qMax<qint64>(1, delay)));
+}
+
+void TimerEngine::onTimeout()
+{
+    ++m_wakeups;
+    if (!m_running) return;
+
+    if (remainingMs() <= 0) {
+        m_bankedMs = m_durationMs;
+        m_activeMs += m_clock.elapsed();
+        m_running = false;
+        emit ticked(0);
+        emit finished();
+        return;
+    }
+
+    emit ticked(remainingSeconds());
+    arm();
+}
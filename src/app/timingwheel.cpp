@@ -0,0 +1,263 @@
+#include "../headers/timingwheel.h"
+#include <QTimer>
+#include <algorithm>
+#include <iterator>
+
+TimingWheel::TimingWheel(int tickMs, QObject *parent)
+    : QObject(parent)
+    , m_tickMs(qMax(1, tickMs))
+    , m_timer(new QTimer(this))
+{
+    std::fill(std::begin(m_heads), std::end(m_heads), -1);
+
+    m_timer->setInterval(m_tickMs);
+    m_timer->setTimerType(Qt::PreciseTimer);
+    connect(m_timer, &QTimer::timeout, this, &TimingWheel::onTimeout);
+}
+
+TimingWheel::Handle TimingWheel::start(qint64 durationMs)
+{
+    const int index = allocate();
+    Node &node = m_nodes[index];
+
+    // Округляем вверх: таймер не должен сработать раньше заказанного
+    const qint64 ticks = qMax<qint64>(1, (durationMs + m_tickMs - 1) / m_tickMs);
+    node.expiresTick = m_now + ticks;
+    node.state = State::Scheduled;
+    schedule(index);
+
+    m_activeCount++;
+    m_scheduledCount++;
+    updateDriver();
+    return makeHandle(index);
+}
+
+bool TimingWheel::pause(Handle handle)
+{
+    const int index = nodeIndex(handle);
+    if (index < 0 || m_nodes[index].state != State::Scheduled) return false;
+
+    Node &node = m_nodes[index];
+    unlink(index);
+    node.remainingTicks = node.expiresTick - m_now;
+    node.state = State::Paused;
+
+    m_scheduledCount--;
+    updateDriver();
+    return true;
+}
+
+bool TimingWheel::resume(Handle handle)
+{
+    const int index = nodeIndex(handle);
+    if (index < 0 || m_nodes[index].state != State::Paused) return false;
+
+    Node &node = m_nodes[index];
+    node.expiresTick = m_now + qMax<qint64>(1, node.remainingTicks);
+    node.state = State::Scheduled;
+    schedule(index);
+
+    m_scheduledCount++;
+    updateDriver();
+    return true;
+}
+
+bool TimingWheel::cancel(Handle handle)
+{
+    const int index = nodeIndex(handle);
+    if (index < 0) return false;
+
+    if (m_nodes[index].state == State::Scheduled) {
+        unlink(index);
+        m_scheduledCount--;
+    }
+    release(index);
+    m_activeCount--;
+    updateDriver();
+    return true;
+}
+
+bool TimingWheel::isActive(Handle handle) const
+{
+    return nodeIndex(handle) >= 0;
+}
+
+bool TimingWheel::isPaused(Handle handle) const
+{
+    const int index = nodeIndex(handle);
+    return index >= 0 && m_nodes[index].state == State::Paused;
+}
+
+qint64 TimingWheel::remainingMs(Handle handle) const
+{
+    const int index = nodeIndex(handle);
+    if (index < 0) return 0;
+
+    const Node &node = m_nodes[index];
+    const qint64 ticks = (node.state == State::Paused) ? node.remainingTicks
+                                                       : node.expiresTick - m_now;
+    return ticks * m_tickMs;
+}
+
+void TimingWheel::advance(int ticks)
+{
+    for (int i = 0; i < ticks; ++i) {
+        tick();
+    }
+}
+
+void TimingWheel::onTimeout()
+{
+    // Тики считаются от монотонных часов: если срабатывание опоздало,
+    // колесо догоняет пропущенные тики за один раз
+    const qint64 target = m_clockBaseTick + m_clock.elapsed() / m_tickMs;
+    if (target > m_now) {
+        advance(int(target - m_now));
+    }
+}
+
+int TimingWheel::nodeIndex(Handle handle) const
+{
+    const int index = int(handle & 0xFFFFFFFFu) - 1;
+    const quint32 generation = quint32(handle >> 32);
+    if (index < 0 || index >= m_nodes.size()) return -1;
+
+    const Node &node = m_nodes[index];
+    if (node.state == State::Free || node.generation != generation) return -1;
+    return index;
+}
+
+TimingWheel::Handle TimingWheel::makeHandle(int index) const
+{
+    // Индекс хранится со сдвигом на единицу, чтобы нулевой Handle всегда был недействительным
+    return (Handle(m_nodes[index].generation) << 32) | Handle(quint32(index + 1));
+}
+
+int TimingWheel::allocate()
+{
+    if (m_freeHead >= 0) {
+        const int index = m_freeHead;
+        m_freeHead = m_nodes[index].next;
+        m_nodes[index].next = -1;
+        return index;
+    }
+    m_nodes.append(Node());
+    return int(m_nodes.size()) - 1;
+}
+
+void TimingWheel::release(int index)
+{
+    Node &node = m_nodes[index];
+    node.state = State::Free;
+    node.generation++;   // Старые Handle на этот узел перестают действовать
+    node.prev = -1;
+    node.slot = -1;
+    node.next = m_freeHead;
+    m_freeHead = index;
+}
+
+void TimingWheel::schedule(int index)
+{
+    Node &node = m_nodes[index];
+
+    // Дальше самого верхнего уровня не заглядываем: такой таймер встанет в последний
+    // достижимый слот и при спуске будет переложен заново по настоящему дедлайну
+    const qint64 delta = node.expiresTick - m_now;
+    const qint64 target = (delta > kMaxDelta) ? m_now + kMaxDelta : node.expiresTick;
+
+    int level = 0;
+    while (level < kLevels - 1 && (target - m_now) >= (qint64(1) << (kLevelBits * (level + 1)))) {
+        level++;
+    }
+    const int slotIndex = int((target >> (kLevelBits * level)) & (kSlotsPerLevel - 1));
+    const int slot = level * kSlotsPerLevel + slotIndex;
+
+    node.slot = slot;
+    node.prev = -1;
+    node.next = m_heads[slot];
+    if (node.next >= 0) {
+        m_nodes[node.next].prev = index;
+    }
+    m_heads[slot] = index;
+}
+
+void TimingWheel::unlink(int index)
+{
+    Node &node = m_nodes[index];
+    if (node.prev >= 0) {
+        m_nodes[node.prev].next = node.next;
+    } else {
+        m_heads[node.slot] = node.next;
+    }
+    if (node.next >= 0) {
+        m_nodes[node.next].prev = node.prev;
+    }
+    node.prev = -1;
+    node.next = -1;
+    node.slot = -1;
+}
+
+void TimingWheel::cascade(int level)
+{
+    const int slotIndex = int((m_now >> (kLevelBits * level)) & (kSlotsPerLevel - 1));
+    const int slot = level * kSlotsPerLevel + slotIndex;
+
+    // Забираем весь список слота и раскладываем его заново относительно текущего тика
+    int index = m_heads[slot];
+    m_heads[slot] = -1;
+    while (index >= 0) {
+        const int next = m_nodes[index].next;
+        schedule(index);
+        index = next;
+    }
+}
+
+void TimingWheel::tick()
+{
+    m_now++;
+
+    // При обороте нижнего уровня спускаем текущий слот следующего, и так далее вверх
+    for (int level = 1; level < kLevels; ++level) {
+        const qint64 lowerMask = (qint64(1) << (kLevelBits * level)) - 1;
+        if ((m_now & lowerMask) != 0) break;
+        cascade(level);
+    }
+
+    // Все таймеры нижнего слота истекают ровно на этом тике
+    const int slot = int(m_now & (kSlotsPerLevel - 1));
+    int index = m_heads[slot];
+    m_heads[slot] = -1;
+    if (index < 0) return;
+
+    m_expired.clear();
+    while (index >= 0) {
+        const int next = m_nodes[index].next;
+        m_expired.append(makeHandle(index));
+        release(index);
+        m_activeCount--;
+        m_scheduledCount--;
+        index = next;
+    }
+    updateDriver();
+
+    // Сигналы отправляются после освобождения узлов, поэтому обработчик
+    // может свободно запускать и отменять таймеры
+    QVector<Handle> fired;
+    fired.swap(m_expired);
+    for (Handle handle : std::as_const(fired)) {
+        emit expired(handle);
+    }
+    fired.clear();
+    m_expired.swap(fired);   // Сохраняем выделенную память буфера на следующий тик
+}
+
+void TimingWheel::updateDriver()
+{
+    if (m_scheduledCount > 0 && !m_timer->isActive()) {
+        m_clock.start();
+        m_clockBaseTick = m_now;
+        m_timer->start();
+    } else if (m_scheduledCount == 0 && m_timer->isActive()) {
+        m_timer->stop();
+    }
+}
@@ -0,0 +1,206 @@
+#include "../headers/trace.h"
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThread>
+#include <QDebug>
+#include <QCoreApplication>
+#include <memory>
+#include <vector>
+
+namespace {
+
+// Ячейка кольцевого буфера. Поля атомарны, а sequence работает как seqlock:
+// нечётное значение — ячейка переписывается, 2 * (номер + 1) — событие с этим
+// номером записано целиком. Поток-владелец пишет, выгрузка только читает
+struct Slot {
+    std::atomic<quint64>     sequence{0};
+    std::atomic<const char *> name{nullptr};
+    std::atomic<qint64>      timestampNs{0};
+    std::atomic<qint64>      value{0};
+    std::atomic<char>        phase{0};
+};
+
+struct ThreadBuffer {
+    ThreadBuffer(int tid, const QByteArray &threadName, int capacity)
+        : tid(tid), threadName(threadName), capacity(capacity), slots(new Slot[size_t(capacity)])
+    {
+    }
+
+    const int                 tid;
+    const QByteArray          threadName;
+    const int                 capacity;
+    std::unique_ptr<Slot[]>   slots;
+    std::atomic<quint64>      head{0};   // Сколько событий записано за всё время
+};
+
+// Общий реестр буферов. Мьютекс берётся только при первом событии потока
+// и при выгрузке, запись событий его не касается. Буферы живут до выхода
+// из программы, поэтому указатель в thread_local не может повиснуть
+struct Registry {
+    QMutex                                     mutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+    QString                                    outputPath;
+    int                                        eventsPerThread = Trace::kDefaultEventsPerThread;
+    QElapsedTimer                              clock;
+};
+
+Registry &registry()
+{
+    static Registry instance;
+    return instance;
+}
+
+thread_local ThreadBuffer *t_buffer = nullptr;
+
+ThreadBuffer *registerThread()
+{
+    Registry &reg = registry();
+    QMutexLocker locker(&reg.mutex);
+
+    QByteArray name = QThread::currentThread()->objectName().toUtf8();
+    if (name.isEmpty()) {
+        const bool mainThread = QCoreApplication::instance()
+                                && QThread::currentThread() == QCoreApplication::instance()->thread();
+        name = mainThread ? QByteArray("главный поток") : "поток " + QByteArray::number(int(reg.buffers.size()));
+    }
+    reg.buffers.push_back(std::make_unique<ThreadBuffer>(int(reg.buffers.size()) + 1, name, reg.eventsPerThread));
+    t_buffer = reg.buffers.back().get();
+    return t_buffer;
+}
+
+void appendEscaped(QByteArray &out, const char *text)
+{
+    for (const char *c = text; *c; ++c) {
+        switch (*c) {
+        case '"':  out += "\\\""; break;
+        case '\\': out += "\\\\"; break;
+        case '\n': out += "\\n"; break;
+        default:
+            if (uchar(*c) < 0x20) {
+                out += "\\u00";
+                out += QByteArray::number(uchar(*c), 16).rightJustified(2, '0');
+            } else {
+                out += *c;
+            }
+        }
+    }
+}
+
+// Микросекунды с долями: так ожидает формат trace-event
+QByteArray microseconds(qint64 ns)
+{
+    return QByteArray::number(double(ns) / 1000.0, 'f', 3);
+}
+
+} // namespace
+
+void Trace::start(const QString &outputPath, int eventsPerThread)
+{
+    Registry &reg = registry();
+    {
+        QMutexLocker locker(&reg.mutex);
+        reg.outputPath = outputPath;
+        // Размер буферов уже созданных потоков не меняется
+        reg.eventsPerThread = qMax(16, eventsPerThread);
+        if (!reg.clock.isValid()) reg.clock.start();
+    }
+    s_enabled.store(true, std::memory_order_release);
+    qInfo() << "Трассировка включена, файл:" << outputPath;
+}
+
+qint64 Trace::nowNs()
+{
+    return registry().clock.nsecsElapsed();
+}
+
+void Trace::record(Phase phase, const char *name, qint64 timestampNs, qint64 value)
+{
+    ThreadBuffer *buffer = t_buffer ? t_buffer : registerThread();
+
+    const quint64 index = buffer->head.load(std::memory_order_relaxed);
+    Slot &slot = buffer->slots[size_t(index % quint64(buffer->capacity))];
+    slot.sequence.store(2 * index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.timestampNs.store(timestampNs, std::memory_order_relaxed);
+    slot.value.store(value, std::memory_order_relaxed);
+    slot.phase.store(char(phase), std::memory_order_relaxed);
+    slot.sequence.store(2 * (index + 1), std::memory_order_release);
+    buffer->head.store(index + 1, std::memory_order_release);
+}
+
+bool Trace::finish()
+{
+    if (!s_enabled.exchange(false)) return false;
+
+    Registry &reg = registry();
+    QMutexLocker locker(&reg.mutex);
+
+    QByteArray json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first = true;
+    auto separator = [&json, &first]() {
+        if (!first) json += ",\n";
+        first = false;
+    };
+
+    quint64 written = 0;
+    quint64 dropped = 0;
+    for (const auto &buffer : reg.buffers) {
+        separator();
+        json += "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":" + QByteArray::number(buffer->tid)
+                + ",\"args\":{\"name\":\"";
+        appendEscaped(json, buffer->threadName.constData());
+        json += "\"}}";
+
+        // Выгружаем последние capacity событий; ячейку, которую поток как раз
+        // переписывает, пропускаем по несовпадению номера
+        const quint64 head = buffer->head.load(std::memory_order_acquire);
+        const quint64 capacity = quint64(buffer->capacity);
+        const quint64 begin = head > capacity ? head - capacity : 0;
+        dropped += begin;
+        for (quint64 index = begin; index < head; ++index) {
+            const Slot &slot = buffer->slots[size_t(index % capacity)];
+            const quint64 expected = 2 * (index + 1);
+            if (slot.sequence.load(std::memory_order_acquire) != expected) continue;
+            const char *name = slot.name.load(std::memory_order_relaxed);
+            const qint64 timestampNs = slot.timestampNs.load(std::memory_order_relaxed);
+            const qint64 value = slot.value.load(std::memory_order_relaxed);
+            const char phase = slot.phase.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(std::memory_order_relaxed) != expected || !name) continue;
+
+            separator();
+            json += "{\"ph\":\"";
+            json += phase;
+            json += "\",\"name\":\"";
+            appendEscaped(json, name);
+            json += "\",\"pid\":1,\"tid\":" + QByteArray::number(buffer->tid)
+                    + ",\"ts\":" + microseconds(timestampNs);
+            if (phase == Complete) {
+                json += ",\"dur\":" + microseconds(value);
+            } else if (phase == Counter) {
+                json += ",\"args\":{\"value\":" + QByteArray::number(value) + "}";
+            } else {
+                json += ",\"s\":\"t\"";
+            }
+            json += "}";
+            ++written;
+        }
+    }
+    json += "\n]}\n";
+
+    QFile file(reg.outputPath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) || file.write(json) != json.size()) {
+        qWarning() << "Не удалось записать трассировку:" << reg.outputPath << file.errorString();
+        return false;
+    }
+    qInfo().noquote() << QString("Трассировка записана в %1: событий %2, потоков %3, затёрто при переполнении %4")
+                             .arg(reg.outputPath)
+                             .arg(written)
+                             .arg(reg.buffers.size())
+                             .arg(dropped);
+    return true;
+}
@@ -0,0 +1,95 @@
+#include "benchdata.h"
+#include "../headers/quotepackwriter.h"
+#include "../headers/quotestore.h"
+#include <QFile>
+#include <QRandomGenerator>
+#include <QTemporaryDir>
+#include <QDebug>
+
+namespace {
+
+const char *const kWords[] = {
+    "время", "успех", "начало", "каждый", "день", "шаг", "цель", "путь", "сила", "воля",
+    "работа", "мысль", "дело", "жизнь", "привычка", "терпение", "вперёд", "сегодня", "завтра", "главное",
+    "маленький", "большой", "результат", "трудно", "легко", "всегда", "никогда", "можно", "нужно", "верить",
+    "Focus", "progress", "habit", "small", "steps", "every", "day", "matters", "start", "now"
+};
+constexpr int kWordCount = int(sizeof(kWords) / sizeof(kWords[0]));
+
+QTemporaryDir &dataDir()
+{
+    static QTemporaryDir dir;
+    return dir;
+}
+
+// Одна строка коллекции: от 6 до 15 слов и порядковый номер,
+// чтобы идентификаторы цитат не совпадали
+QByteArray quoteLine(QRandomGenerator &random, int index)
+{
+    QByteArray line;
+    const int length = random.bounded(6, 16);
+    for (int w = 0; w < length; ++w) {
+        if (w > 0) line += ' ';
+        line += kWords[random.bounded(kWordCount)];
+    }
+    line += " #";
+    line += QByteArray::number(index);
+    return line;
+}
+
+} // namespace
+
+QStringList BenchData::quotes(int count)
+{
+    QRandomGenerator random(42);
+    QStringList result;
+    result.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        result.append(QString::fromUtf8(quoteLine(random, i)));
+    }
+    return result;
+}
+
+QString BenchData::tempPath(const QString &name)
+{
+    return dataDir().filePath(name);
+}
+
+QString BenchData::quotesFile(int count)
+{
+    const QString path = tempPath(QString("quotes_%1.txt").arg(count));
+    if (QFile::exists(path)) return path;
+
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Не удалось создать файл цитат для бенчмарка:" << path;
+        return path;
+    }
+
+    // Пишем крупными блоками: миллион строк — около 80 МБ
+    QRandomGenerator random(42);
+    QByteArray chunk;
+    for (int i = 0; i < count; ++i) {
+        chunk += quoteLine(random, i);
+        chunk += '\n';
+        if (chunk.size() >= (1 << 20)) {
+            file.write(chunk);
+            chunk.clear();
+        }
+    }
+    file.write(chunk);
+    return path;
+}
+
+QString BenchData::quotesPack(int count)
+{
+    const QString path = tempPath(QString("quotes_%1.qpack").arg(count));
+    if (QFile::exists(path)) return path;
+
+    QuoteStore store;
+    QString error;
+    if (!store.loadFile(quotesFile(count)) || !QuotePack::write(store, path, &error)) {
+        qWarning() << "Не удалось собрать пакет цитат для бенчмарка:" << path << error;
+    }
+    return path;
+}
@@ -0,0 +1,20 @@
+#ifndef BENCHDATA_H
+#define BENCHDATA_H
+
+#include <QString>
+#include <QStringList>
+
+// Синтетические коллекции цитат для бенчмарков. Текст детерминирован
+// (фиксированное зерно), поэтому замеры разных сборок сравнимы.
+// Файлы создаются при первом обращении во временном каталоге и
+// переиспользуются всеми наборами до выхода из программы.
+namespace BenchData {
+
+QStringList quotes(int count);      // Цитаты в памяти
+QString     quotesFile(int count);  // Текстовый файл, по цитате на строку
+QString     quotesPack(int count);  // Пакет .qpack той же коллекции
+QString     tempPath(const QString &name);   // Путь внутри общего временного каталога
+
+} // namespace BenchData
+
+#endif // BENCHDATA_H
@@ -0,0 +1,111 @@
+// Набор бенчмарков горячих путей приложения.
+// Аргументы командной строки передаются в QTest как есть, например:
+//   antiprocrastinator_bench -iterations 1000
+//   antiprocrastinator_bench -tickcounter
+// Для отслеживания регрессий результаты можно сохранить в файлы:
+//   antiprocrastinator_bench -resultdir results [-resultformat csv|xml|junitxml]
+// Каждый набор пишет <каталог>/<Набор>.<формат>, вывод в консоль сохраняется.
+
+#include <QApplication>
+#include <QDir>
+#include <QtTest>
+#include "repositorybench.h"
+#include "timingwheelbench.h"
+#include "themebench.h"
+#include "quoteindexbench.h"
+#include "quotestorebench.h"
+#include "progressbench.h"
+#include "quotesdialogbench.h"
+#include "tracebench.h"
+#include "journalbench.h"
+#include "countdownbench.h"
+#include "profilesbench.h"
+
+namespace {
+
+// Забирает из аргументов собственный ключ со значением, QTest его не знает
+QString takeOption(QStringList &args, const QString &name, const QString &defaultValue = QString())
+{
+    const int index = int(args.indexOf(name));
+    if (index < 0 || index + 1 >= args.size()) return defaultValue;
+    const QString value = args.at(index + 1);
+    args.remove(index, 2);
+    return value;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    // Виджетам для замеров тем не нужен дисплей
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QApplication app(argc, argv);
+
+    QStringList args = app.arguments();
+    const QString resultDir = takeOption(args, "-resultdir");
+    const QString resultFormat = takeOption(args, "-resultformat", "csv");
+    if (!resultDir.isEmpty() && !QDir().mkpath(resultDir)) {
+        qCritical() << "Не удалось создать каталог результатов:" << resultDir;
+        return 1;
+    }
+
+    auto run = [&](QObject *suite) {
+        QStringList suiteArgs = args;
+        if (!resultDir.isEmpty()) {
+            const QString file = QDir(resultDir).filePath(
+                QString("%1.%2").arg(suite->metaObject()->className(),
+                                     resultFormat == "junitxml" ? "xml" : resultFormat));
+            suiteArgs << "-o" << file + "," + resultFormat << "-o" << "-,txt";
+        }
+        return QTest::qExec(suite, suiteArgs);
+    };
+
+    int status = 0;
+    {
+        RepositoryBench bench;
+        status |= run(&bench);
+    }
+    {
+        TimingWheelBench bench;
+        status |= run(&bench);
+    }
+    {
+        ThemeBench bench;
+        status |= run(&bench);
+    }
+    {
+        QuoteIndexBench bench;
+        status |= run(&bench);
+    }
+    {
+        QuoteStoreBench bench;
+        status |= run(&bench);
+    }
+    {
+        ProgressBench bench;
+        status |= run(&bench);
+    }
+    {
+        QuotesDialogBench bench;
+        status |= run(&bench);
+    }
+    {
+        TraceBench bench;
+        status |= run(&bench);
+    }
+    {
+        JournalBench bench;
+        status |= run(&bench);
+    }
+    {
+        CountdownBench bench;
+        status |= run(&bench);
+    }
+    {
+        ProfilesBench bench;
+        status |= run(&bench);
+    }
+    return status;
+}
@@ -0,0 +1,129 @@
+#include "countdownbench.h"
+#include "../headers/countdowndisplay.h"
+#include "../headers/theme.h"
+#include <QtTest>
+#include <QApplication>
+#include <QComboBox>
+#include <QLabel>
+#include <QPaintEvent>
+#include <QPushButton>
+#include <QSpinBox>
+#include <QVBoxLayout>
+
+namespace {
+
+constexpr int kStartSeconds = 25 * 60;
+
+// Считает перекладки окна и площадь, которую перерисовывают виджеты
+class TickCounter : public QObject
+{
+public:
+    TickCounter() { qApp->installEventFilter(this); }
+    ~TickCounter() override { qApp->removeEventFilter(this); }
+
+    int    ticks = 0;
+    int    layoutRequests = 0;
+    int    paints = 0;
+    qint64 paintedPixels = 0;
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override
+    {
+        if (event->type() == QEvent::LayoutRequest) {
+            ++layoutRequests;
+        } else if (event->type() == QEvent::Paint && watched->isWidgetType()) {
+            ++paints;
+            const QRect rect = static_cast<QPaintEvent *>(event)->rect();
+            paintedPixels += qint64(rect.width()) * rect.height();
+        }
+        return QObject::eventFilter(watched, event);
+    }
+};
+
+void report(const char *path, const TickCounter &counter)
+{
+    const int ticks = qMax(1, counter.ticks);
+    qInfo().noquote() << QString("%1: перекладок %2, отрисовок виджетов %3, перерисовано %4 пикс. за тик")
+                             .arg(path)
+                             .arg(double(counter.layoutRequests) / ticks, 0, 'f', 2)
+                             .arg(double(counter.paints) / ticks, 0, 'f', 2)
+                             .arg(counter.paintedPixels / ticks);
+}
+
+QString format(int seconds)
+{
+    return QString("%1:%2").arg(seconds / 60, 2, 10, QChar('0')).arg(seconds % 60, 2, 10, QChar('0'));
+}
+
+} // namespace
+
+QWidget *CountdownBench::makeWindow(QWidget *timeWidget)
+{
+    auto *window = new QWidget;
+    auto *layout = new QVBoxLayout(window);
+    timeWidget->setParent(window);
+    timeWidget->setFont(Theme::timeFont());
+    timeWidget->setPalette(Theme::current().timePalette());
+    layout->addWidget(timeWidget);
+    layout->addWidget(new QLabel("Сессий завершено: 0", window));
+    layout->addWidget(new QLabel("Цитата", window));
+    layout->addWidget(new QPushButton("Старт", window));
+    layout->addWidget(new QComboBox(window));
+    layout->addWidget(new QSpinBox(window));
+    layout->addStretch();
+    window->resize(450, 400);
+    window->show();
+    return window;
+}
+
+void CountdownBench::initTestCase()
+{
+    Theme::apply(Theme::light());
+
+    m_label = new QLabel(format(kStartSeconds));
+    m_label->setAlignment(Qt::AlignCenter);
+    m_label->setContentsMargins(0, 10, 0, 10);
+    m_labelWindow.reset(makeWindow(m_label));
+
+    m_display = new CountdownDisplay;
+    m_display->setRemainingSeconds(kStartSeconds);
+    m_displayWindow.reset(makeWindow(m_display));
+
+    QVERIFY(QTest::qWaitForWindowExposed(m_labelWindow.data()));
+    QVERIFY(QTest::qWaitForWindowExposed(m_displayWindow.data()));
+}
+
+void CountdownBench::cleanupTestCase()
+{
+    m_labelWindow.reset();
+    m_displayWindow.reset();
+}
+
+void CountdownBench::tickLabel()
+{
+    // Как updateDisplay до табло: новая строка и setText на каждую секунду
+    int seconds = kStartSeconds;
+    QApplication::processEvents();
+    TickCounter counter;
+    QBENCHMARK {
+        seconds = seconds > 0 ? seconds - 1 : kStartSeconds;
+        m_label->setText(format(seconds));
+        QApplication::processEvents();
+        ++counter.ticks;
+    }
+    report("QLabel", counter);
+}
+
+void CountdownBench::tickDisplay()
+{
+    int seconds = kStartSeconds;
+    QApplication::processEvents();
+    TickCounter counter;
+    QBENCHMARK {
+        seconds = seconds > 0 ? seconds - 1 : kStartSeconds;
+        m_display->setRemainingSeconds(seconds);
+        QApplication::processEvents();
+        ++counter.ticks;
+    }
+    report("CountdownDisplay", counter);
+}
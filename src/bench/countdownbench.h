@@ -0,0 +1,35 @@
+#ifndef COUNTDOWNBENCH_H
+#define COUNTDOWNBENCH_H
+
+#include <QObject>
+#include <QScopedPointer>
+#include <QWidget>
+
+class QLabel;
+class CountdownDisplay;
+
+// Секунда отсчёта в главном окне: прежний QLabel с setText против табло
+// CountdownDisplay с атласом цифр. Каждая итерация — смена времени и
+// обработка событий до отрисовки. Кроме времени, для каждого пути печатается
+// число перекладок (LayoutRequest) и перерисованная площадь за тик
+class CountdownBench : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void tickLabel();
+    void tickDisplay();
+
+private:
+    QWidget *makeWindow(QWidget *timeWidget);   // Те же виджеты под таймером, что в главном окне
+
+    QScopedPointer<QWidget> m_labelWindow;
+    QScopedPointer<QWidget> m_displayWindow;
+    QLabel           *m_label = nullptr;
+    CountdownDisplay *m_display = nullptr;
+};
+
+#endif // COUNTDOWNBENCH_H
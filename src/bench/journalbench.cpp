@@ -0,0 +1,81 @@
+#include "journalbench.h"
+#include "benchdata.h"
+#include "../headers/sessionjournal.h"
+#include "../headers/progressrepository.h"
+#include <QtTest>
+#include <QFile>
+
+namespace {
+
+constexpr qint64 kDurationMs = 25 * 60 * 1000;
+
+} // namespace
+
+void JournalBench::journalAppend()
+{
+    const QString path = BenchData::tempPath("journal_append.sessionlog");
+    QFile::remove(path);
+    SessionJournal journal;
+    QVERIFY(journal.open(path));
+    journal.start(kDurationMs);
+
+    // pause пишет запись безусловно, в отличие от checkpoint с его интервалом
+    qint64 elapsed = 0;
+    QBENCHMARK {
+        journal.pause(++elapsed);
+    }
+}
+
+void JournalBench::journalAppendSync()
+{
+    const QString path = BenchData::tempPath("journal_sync.sessionlog");
+    QFile::remove(path);
+    SessionJournal journal;
+    QVERIFY(journal.open(path));
+    journal.start(kDurationMs);
+
+    qint64 elapsed = 0;
+    QBENCHMARK {
+        journal.pause(++elapsed);
+        journal.sync();
+    }
+}
+
+void JournalBench::sqliteTransaction()
+{
+    // Те же настройки, что у потока записи: WAL и synchronous=NORMAL
+    const QString path = BenchData::tempPath("journal_sqlite.db");
+    QFile::remove(path);
+    ProgressRepository repository("bench_journal");
+    QVERIFY(repository.open(path));
+    QVERIFY(repository.initSchema());
+    repository.exec("PRAGMA journal_mode=WAL");
+    repository.exec("PRAGMA synchronous=NORMAL");
+
+    qint64 elapsed = 0;
+    QBENCHMARK {
+        repository.transaction();
+        repository.setCounter("bench_elapsed", ++elapsed);
+        repository.commit();
+    }
+}
+
+void JournalBench::replay()
+{
+    // Типичный журнал после падения: старт, несколько пауз и контрольных точек
+    const QString path = BenchData::tempPath("journal_replay.sessionlog");
+    QFile::remove(path);
+    {
+        SessionJournal journal;
+        QVERIFY(journal.open(path));
+        journal.start(kDurationMs);
+        for (int i = 1; i <= 100; ++i) {
+            journal.pause(i * 1000);
+        }
+    }
+
+    QBENCHMARK {
+        SessionJournal journal;
+        journal.open(path);
+    }
+}
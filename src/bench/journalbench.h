@@ -0,0 +1,20 @@
+#ifndef JOURNALBENCH_H
+#define JOURNALBENCH_H
+
+#include <QObject>
+
+// Цена сохранения состояния таймера: запись в журнал сессий без fsync
+// (так пишутся контрольные точки), с fsync (так пишется завершение),
+// транзакция SQLite в режиме потока записи для сравнения и проигрывание журнала
+class JournalBench : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void journalAppend();
+    void journalAppendSync();
+    void sqliteTransaction();
+    void replay();
+};
+
+#endif // JOURNALBENCH_H
@@ -0,0 +1,98 @@
+#include "profilesbench.h"
+#include "benchdata.h"
+#include "../headers/connectionpool.h"
+#include "../headers/profilestats.h"
+#include <QtTest>
+#include <QSqlQuery>
+#include <QFile>
+
+namespace {
+
+constexpr int kProfiles = 8;
+constexpr int kSessionsPerProfile = 100000;
+
+} // namespace
+
+ProfilesBench::ProfilesBench() = default;
+ProfilesBench::~ProfilesBench() = default;
+
+void ProfilesBench::initTestCase()
+{
+    m_pool = std::make_unique<ConnectionPool>(BenchData::tempPath("profiles_main.db"));
+    m_profiles << ConnectionPool::kDefaultProfile;
+    for (int i = 1; i < kProfiles; ++i) {
+        m_profiles << QString("bench%1").arg(i);
+    }
+
+    // Шарды создаются один раз и переиспользуются следующими прогонами
+    for (const QString &profile : std::as_const(m_profiles)) {
+        QString error;
+        ProgressRepository *repository = m_pool->acquire(profile, nullptr, &error);
+        QVERIFY2(repository, qPrintable(error));
+        if (repository->sessionCount() >= kSessionsPerProfile) continue;
+
+        // Сессии раз в полчаса в прошлое: триггеры заполняют счётчик и свёртки, как в жизни
+        repository->transaction();
+        QSqlQuery insert(repository->database());
+        insert.prepare(R"(
+            WITH RECURSIVE n(i) AS (SELECT 1 UNION ALL SELECT i + 1 FROM n WHERE i < ?)
+            INSERT INTO sessions (start_time, duration_minutes)
+            SELECT datetime('now', printf('-%d minutes', (? - i) * 30)), 25 FROM n
+        )");
+        insert.bindValue(0, kSessionsPerProfile);
+        insert.bindValue(1, kSessionsPerProfile);
+        QVERIFY(insert.exec());
+        insert.finish();
+        QVERIFY(repository->commit());
+    }
+}
+
+void ProfilesBench::cleanupTestCase()
+{
+    // Пул останавливает свои потоки чтения, и они закрывают свои соединения сами
+    m_pool.reset();
+}
+
+void ProfilesBench::summarizeSerial()
+{
+    const QDate today = QDate::currentDate();
+    int sessions = 0;
+    QBENCHMARK {
+        sessions = 0;
+        for (const QString &profile : std::as_const(m_profiles)) {
+            sessions += ProfileStats::summarize(m_pool.get(), profile, today).sessions;
+        }
+    }
+    QCOMPARE(sessions, kProfiles * kSessionsPerProfile);
+}
+
+void ProfilesBench::summarizeParallel()
+{
+    const QDate today = QDate::currentDate();
+    ProfileSummary total;
+    QBENCHMARK {
+        total = ProfileStats::combine(ProfileStats::collect(m_pool.get(), m_profiles, today).results());
+    }
+    QCOMPARE(total.sessions, kProfiles * kSessionsPerProfile);
+}
+
+void ProfilesBench::switchCached()
+{
+    // Переключение туда и обратно: оба соединения главного потока уже в пуле
+    int index = 0;
+    QBENCHMARK {
+        ProgressRepository *repository = m_pool->acquire(m_profiles.at(index++ % kProfiles));
+        repository->sessionCount();
+    }
+}
+
+void ProfilesBench::switchReopen()
+{
+    int index = 0;
+    QBENCHMARK {
+        ProgressRepository repository("bench_profiles_reopen");
+        repository.open(m_pool->shardPath(m_profiles.at(index++ % kProfiles)), "QSQLITE_BUSY_TIMEOUT=5000");
+        repository.sessionCount();
+        repository.close();
+    }
+}
@@ -0,0 +1,37 @@
+#ifndef PROFILESBENCH_H
+#define PROFILESBENCH_H
+
+#include <QObject>
+#include <QStringList>
+#include <memory>
+
+class ConnectionPool;
+
+// Профили с отдельными базами.
+// summarizeSerial и summarizeParallel — сводка по 8 шардам по 100 000 сессий:
+// по очереди в одном потоке и параллельно через ProfileStats::collect.
+// switchCached — соединение профиля из пула, как при переключении профиля в окне;
+// switchReopen — прежний путь с открытием базы и закрытием после чтения
+class ProfilesBench : public QObject
+{
+    Q_OBJECT
+
+public:
+    ProfilesBench();
+    ~ProfilesBench() override;
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void summarizeSerial();
+    void summarizeParallel();
+    void switchCached();
+    void switchReopen();
+
+private:
+    std::unique_ptr<ConnectionPool> m_pool;
+    QStringList                     m_profiles;
+};
+
+#endif // PROFILESBENCH_H
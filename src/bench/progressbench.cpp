@@ -0,0 +1,168 @@
+#include "progressbench.h"
+#include "benchdata.h"
+#include "../headers/progressrepository.h"
+#include "../headers/persistenceworker.h"
+#include "../headers/connectionpool.h"
+#include "../headers/settingsstore.h"
+#include <QtTest>
+#include <QSignalSpy>
+#include <QEventLoop>
+#include <QSqlQuery>
+#include <QFile>
+
+namespace {
+
+constexpr int kQuotes = 100000;
+const char kConnection[] = "bench_progress";
+
+} // namespace
+
+void ProgressBench::initTestCase()
+{
+    QVERIFY(m_quotes.loadPack(BenchData::quotesPack(kQuotes)));
+}
+
+QString ProgressBench::sessionsDb(int sessions)
+{
+    const QString path = BenchData::tempPath(QString("progress_%1.db").arg(sessions));
+    if (QFile::exists(path)) return path;
+
+    ProgressRepository repository(kConnection);
+    if (!repository.open(path) || !repository.initSchema()) {
+        qWarning() << "Не удалось создать бд для бенчмарка:" << repository.lastError();
+        return path;
+    }
+    repository.seedSettings("light", 25);
+    repository.exec("PRAGMA journal_mode=WAL");
+
+    // Сессии раз в полчаса в прошлое: триггеры заполняют счётчик и свёртки, как в жизни
+    repository.transaction();
+    QSqlQuery insert(repository.database());
+    insert.prepare(R"(
+        WITH RECURSIVE n(i) AS (SELECT 1 UNION ALL SELECT i + 1 FROM n WHERE i < ?)
+        INSERT INTO sessions (start_time, duration_minutes)
+        SELECT datetime('now', printf('-%d minutes', (? - i) * 30)), 25 FROM n
+    )");
+    insert.bindValue(0, sessions);
+    insert.bindValue(1, sessions);
+    insert.exec();
+    insert.finish();
+
+    // Каждая сессия открыла по цитате, пока они не кончились
+    const int unlocked = qMin(sessions, m_quotes.size());
+    for (int i = 0; i < unlocked; ++i) {
+        repository.unlockQuoteForSession(i + 1, m_quotes.id(i));
+    }
+    repository.exec("INSERT OR REPLACE INTO counters (name, value) VALUES ('unlocks_migrated', 1)");
+    repository.commit();
+    return path;
+}
+
+void ProgressBench::loadProgress_data()
+{
+    QTest::addColumn<int>("sessions");
+    QTest::newRow("10k") << 10000;
+    QTest::newRow("100k") << 100000;
+    QTest::newRow("1M") << 1000000;
+}
+
+void ProgressBench::loadProgress()
+{
+    QFETCH(int, sessions);
+    const QString path = sessionsDb(sessions);
+
+    // Тот же порядок, что в readStartupSnapshot и Antiprocrastinator::loadProgress
+    int restored = 0;
+    QBENCHMARK {
+        ProgressRepository repository(kConnection);
+        repository.open(path);
+        repository.initSchema();
+        repository.seedSettings("light", 25);
+        repository.sessionCount();
+        const QVector<quint64> ids = repository.unlockedQuoteIds();
+        repository.getSetting("theme");
+        repository.getSetting("duration");
+        restored = m_quotes.setUnlockedIds(ids);
+    }
+    QCOMPARE(restored, qMin(sessions, m_quotes.size()));
+}
+
+void ProgressBench::recordSessionEnqueue()
+{
+    const QString path = BenchData::tempPath("progress_writer.db");
+    {
+        ProgressRepository repository(kConnection);
+        QVERIFY(repository.open(path));
+        QVERIFY(repository.initSchema());
+    }
+
+    // Поток интерфейса только кладёт команду в очередь; запись идёт параллельно
+    // и дописывается в деструкторе, вне замера
+    ConnectionPool pool(path);
+    PersistenceWorker writer(&pool, ConnectionPool::kDefaultProfile);
+    quint64 quoteId = 0;
+    QBENCHMARK {
+        WriteCommand command;
+        command.type = WriteCommand::RecordSession;
+        command.durationMinutes = 25;
+        command.unlocksQuote = true;
+        command.quoteId = ++quoteId;
+        writer.enqueue(command);
+    }
+}
+
+void ProgressBench::recordSessionRoundTrip()
+{
+    const QString path = BenchData::tempPath("progress_writer.db");
+    {
+        ProgressRepository repository(kConnection);
+        QVERIFY(repository.open(path));
+        QVERIFY(repository.initSchema());
+    }
+
+    // Сигналы из потока записи доходят через очередь главного потока,
+    // поэтому ответ не теряется, даже если пришёл раньше входа в цикл
+    ConnectionPool pool(path);
+    PersistenceWorker writer(&pool, ConnectionPool::kDefaultProfile);
+    QSignalSpy failed(&writer, &PersistenceWorker::writeFailed);
+    QEventLoop loop;
+    connect(&writer, &PersistenceWorker::sessionRecorded, &loop, &QEventLoop::quit);
+    connect(&writer, &PersistenceWorker::writeFailed, &loop, &QEventLoop::quit);
+    quint64 quoteId = quint64(1) << 40;
+    QBENCHMARK {
+        WriteCommand command;
+        command.type = WriteCommand::RecordSession;
+        command.durationMinutes = 25;
+        command.unlocksQuote = true;
+        command.quoteId = ++quoteId;
+        writer.enqueue(command);
+        loop.exec();
+    }
+    QCOMPARE(failed.count(), 0);
+}
+
+void ProgressBench::settingsBurst()
+{
+    const QString path = BenchData::tempPath("progress_writer.db");
+    ConnectionPool pool(path);
+    PersistenceWorker writer(&pool, ConnectionPool::kDefaultProfile);
+
+    // Как saveProgress при каждом шаге спинбокса: тема та же, длительность новая.
+    // Цикл событий не крутится, поэтому таймер тишины не срабатывает до flush
+    constexpr int kSteps = 50;
+    SettingsStore settings(&writer, ConnectionPool::kDefaultProfile);
+    int minutes = 5;
+    QBENCHMARK {
+        for (int i = 0; i < kSteps; ++i) {
+            minutes = minutes % 60 + 1;
+            settings.setValues({{"theme", "light"}, {"duration", QString::number(minutes)}});
+        }
+        settings.flush();
+    }
+    qInfo().noquote() << QString("Сохранений %1, транзакций %2, сэкономлено %3")
+                             .arg(settings.saveRequests())
+                             .arg(settings.transactions())
+                             .arg(settings.writesAvoided());
+    QCOMPARE(settings.writesAvoided(), settings.saveRequests() - settings.transactions());
+    QVERIFY(settings.transactions() <= settings.saveRequests() / kSteps);
+}
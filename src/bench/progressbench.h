@@ -0,0 +1,35 @@
+#ifndef PROGRESSBENCH_H
+#define PROGRESSBENCH_H
+
+#include <QObject>
+#include "../headers/quotestore.h"
+
+// Путь прогресса главного окна.
+// loadProgress — чтение снимка бд при запуске (схема, счётчик, настройки,
+// открытые цитаты) и восстановление открытых цитат в коллекции из 100 000,
+// для истории в 10 000, 100 000 и 1 000 000 сессий.
+// timerFinished — запись завершённой сессии с открытой цитатой: стоимость
+// постановки в очередь для потока интерфейса и полный путь до сигнала
+// sessionRecorded из потока записи.
+// settingsBurst — удержание стрелки длительности: 50 сохранений подряд
+// через SettingsStore и одна запись пачкой; печатает сэкономленные транзакции
+class ProgressBench : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void loadProgress_data();
+    void loadProgress();
+    void recordSessionEnqueue();
+    void recordSessionRoundTrip();
+    void settingsBurst();
+
+private:
+    QString sessionsDb(int sessions);   // База с заданной историей, создаётся при первом обращении
+
+    QuoteStore m_quotes;
+};
+
+#endif // PROGRESSBENCH_H
@@ -0,0 +1,98 @@
+#include "quoteindexbench.h"
+#include <QtTest>
+#include <QRandomGenerator>
+#include <QStringList>
+
+namespace {
+
+constexpr int kQuotes = 100000;
+constexpr int kVocabulary = 20000;
+
+// Псевдослова из русских слогов: словарь и распределение длин похожи на настоящие цитаты
+QStringList makeVocabulary(QRandomGenerator &random)
+{
+    static const char16_t *const kSyllables[] = {
+        u"ра", u"бо", u"та", u"вре", u"мя", u"сил", u"ус", u"пех", u"це", u"ль",
+        u"де", u"ло", u"жи", u"знь", u"шаг", u"путь", u"во", u"ля", u"мы", u"сль",
+        u"ёж", u"ки", u"ст", u"но", u"ви", u"ду", u"ха", u"зо", u"ре", u"ня"
+    };
+    constexpr int kSyllableCount = int(sizeof(kSyllables) / sizeof(kSyllables[0]));
+
+    QStringList words;
+    words.reserve(kVocabulary);
+    for (int i = 0; i < kVocabulary; ++i) {
+        QString word;
+        const int syllables = random.bounded(2, 5);
+        for (int s = 0; s < syllables; ++s) {
+            word += QString::fromUtf16(kSyllables[random.bounded(kSyllableCount)]);
+        }
+        if (random.bounded(10) == 0) word[0] = word.at(0).toUpper();
+        words.append(word);
+    }
+    return words;
+}
+
+} // namespace
+
+void QuoteIndexBench::initTestCase()
+{
+    QRandomGenerator random(42);
+    const QStringList vocabulary = makeVocabulary(random);
+
+    QStringList quotes;
+    quotes.reserve(kQuotes);
+    for (int i = 0; i < kQuotes; ++i) {
+        QStringList words;
+        const int length = random.bounded(6, 16);
+        for (int w = 0; w < length; ++w) {
+            words.append(vocabulary.at(random.bounded(kVocabulary)));
+        }
+        quotes.append(words.join(' ') + QStringLiteral("."));
+    }
+    m_store.setQuotes(quotes);
+
+    const QStringList first = QuoteIndex::tokenize(quotes.at(kQuotes / 2));
+    m_word = first.at(0);
+    m_secondWord = first.at(1);
+
+    m_index.build(m_store);
+    QVERIFY(m_index.isBuilt());
+}
+
+void QuoteIndexBench::build100k()
+{
+    QBENCHMARK {
+        QuoteIndex index;
+        index.build(m_store);
+    }
+}
+
+void QuoteIndexBench::searchShortPrefix()
+{
+    // Первые две буквы — самый дорогой запрос: префикс совпадает со многими словами
+    const QString prefix = m_word.left(2);
+    QVector<int> found;
+    QBENCHMARK {
+        found = m_index.search(prefix);
+    }
+    QVERIFY(found.contains(kQuotes / 2));
+}
+
+void QuoteIndexBench::searchWord()
+{
+    QVector<int> found;
+    QBENCHMARK {
+        found = m_index.search(m_word);
+    }
+    QVERIFY(found.contains(kQuotes / 2));
+}
+
+void QuoteIndexBench::searchTwoWords()
+{
+    const QString query = m_word + QStringLiteral(" ") + m_secondWord.left(3);
+    QVector<int> found;
+    QBENCHMARK {
+        found = m_index.search(query);
+    }
+    QVERIFY(found.contains(kQuotes / 2));
+}
@@ -0,0 +1,30 @@
+#ifndef QUOTEINDEXBENCH_H
+#define QUOTEINDEXBENCH_H
+
+#include <QObject>
+#include "../headers/quotestore.h"
+#include "../headers/quoteindex.h"
+
+// Поиск по коллекции из 100 000 цитат на кириллице: построение индекса и
+// ответ на запрос при наборе — короткий префикс, целое слово и два слова.
+// Ответ на нажатие клавиши должен укладываться в малую долю кадра (16 мс)
+class QuoteIndexBench : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void build100k();
+    void searchShortPrefix();
+    void searchWord();
+    void searchTwoWords();
+
+private:
+    QuoteStore m_store;
+    QuoteIndex m_index;
+    QString    m_word;         // Слово, которое точно есть в коллекции
+    QString    m_secondWord;   // Соседнее с ним слово той же цитаты
+};
+
+#endif // QUOTEINDEXBENCH_H
@@ -0,0 +1,31 @@
+#include "quotesdialogbench.h"
+#include "benchdata.h"
+#include "../headers/quotesdialog.h"
+#include "../headers/quoteindex.h"
+#include "../headers/quotestore.h"
+#include <QtTest>
+
+void QuotesDialogBench::construct_data()
+{
+    QTest::addColumn<int>("quotes");
+    QTest::newRow("1k") << 1000;
+    QTest::newRow("100k") << 100000;
+    QTest::newRow("1M") << 1000000;
+}
+
+void QuotesDialogBench::construct()
+{
+    QFETCH(int, quotes);
+
+    // Коллекция из пакета, как при обычном запуске; открыта половина цитат
+    QuoteStore store;
+    QVERIFY(store.loadPack(BenchData::quotesPack(quotes)));
+    store.setUnlockedCount(quotes / 2);
+    QuoteIndex index;
+
+    QBENCHMARK {
+        QuotesDialog dialog(&store, &index);
+        dialog.show();
+        QVERIFY(QTest::qWaitForWindowExposed(&dialog));
+    }
+}
@@ -0,0 +1,18 @@
+#ifndef QUOTESDIALOGBENCH_H
+#define QUOTESDIALOGBENCH_H
+
+#include <QObject>
+
+// Открытие коллекции: создание QuotesDialog и первый показ на платформе
+// offscreen для коллекций на 1 000, 100 000 и 1 000 000 цитат.
+// Благодаря модели и делегату время не должно расти с размером коллекции
+class QuotesDialogBench : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void construct_data();
+    void construct();
+};
+
+#endif // QUOTESDIALOGBENCH_H
@@ -0,0 +1,54 @@
+#include "quotestorebench.h"
+#include "benchdata.h"
+#include "../headers/quotestore.h"
+#include <QtTest>
+
+namespace {
+
+void addCorpusRows()
+{
+    QTest::addColumn<int>("lines");
+    QTest::newRow("1k") << 1000;
+    QTest::newRow("100k") << 100000;
+    QTest::newRow("1M") << 1000000;
+}
+
+} // namespace
+
+void QuoteStoreBench::loadText_data()
+{
+    addCorpusRows();
+}
+
+void QuoteStoreBench::loadText()
+{
+    QFETCH(int, lines);
+    const QString path = BenchData::quotesFile(lines);
+
+    int loaded = 0;
+    QBENCHMARK {
+        QuoteStore store;
+        store.loadFile(path);
+        loaded = store.size();
+    }
+    QCOMPARE(loaded, lines);
+}
+
+void QuoteStoreBench::loadPack_data()
+{
+    addCorpusRows();
+}
+
+void QuoteStoreBench::loadPack()
+{
+    QFETCH(int, lines);
+    const QString path = BenchData::quotesPack(lines);
+
+    int loaded = 0;
+    QBENCHMARK {
+        QuoteStore store;
+        store.loadPack(path);
+        loaded = store.size();
+    }
+    QCOMPARE(loaded, lines);
+}
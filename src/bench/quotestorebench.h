@@ -0,0 +1,20 @@
+#ifndef QUOTESTOREBENCH_H
+#define QUOTESTOREBENCH_H
+
+#include <QObject>
+
+// Загрузка коллекции цитат, как её делает Antiprocrastinator::loadQuotes:
+// текстовый файл с построением индекса строк и готовый пакет .qpack.
+// Коллекции на 1 000, 100 000 и 1 000 000 строк
+class QuoteStoreBench : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void loadText_data();
+    void loadText();
+    void loadPack_data();
+    void loadPack();
+};
+
+#endif // QUOTESTOREBENCH_H
@@ -0,0 +1,138 @@
+#include "repositorybench.h"
+#include "../headers/progressrepository.h"
+#include <QtTest>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+
+namespace {
+
+const char kAdHocConnection[] = "bench_adhoc";
+const char kRepositoryConnection[] = "bench_repository";
+
+QSqlDatabase openAdHoc(const QString &path)
+{
+    QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", kAdHocConnection);
+    db.setDatabaseName(path);
+    db.open();
+    return db;
+}
+
+void closeAdHoc(QSqlDatabase &db)
+{
+    db.close();
+    db = QSqlDatabase();
+    QSqlDatabase::removeDatabase(kAdHocConnection);
+}
+
+} // namespace
+
+QString RepositoryBench::dbPath() const
+{
+    return m_dir.filePath("progress.db");
+}
+
+void RepositoryBench::initTestCase()
+{
+    QVERIFY(m_dir.isValid());
+
+    ProgressRepository repository(kRepositoryConnection);
+    QVERIFY(repository.open(dbPath()));
+    QVERIFY(repository.initSchema());
+    repository.seedSettings("light", 25);
+    // Измеряем стоимость запросов, а не fsync
+    QVERIFY(repository.exec("PRAGMA journal_mode=WAL"));
+    for (int i = 0; i < 1000; ++i) {
+        repository.recordSession(25);
+    }
+}
+
+void RepositoryBench::cleanupTestCase()
+{
+    m_dir.remove();
+}
+
+void RepositoryBench::getSettingAdHoc()
+{
+    QSqlDatabase db = openAdHoc(dbPath());
+    QVERIFY(db.isOpen());
+
+    QString value;
+    QBENCHMARK {
+        QSqlQuery query(db);
+        query.prepare("SELECT value FROM settings WHERE key = 'theme'");
+        if (query.exec() && query.next()) {
+            value = query.value(0).toString();
+        }
+    }
+    QCOMPARE(value, QString("light"));
+    closeAdHoc(db);
+}
+
+void RepositoryBench::getSettingCached()
+{
+    ProgressRepository repository(kRepositoryConnection);
+    QVERIFY(repository.open(dbPath()));
+
+    QString value;
+    QBENCHMARK {
+        value = repository.getSetting("theme");
+    }
+    QCOMPARE(value, QString("light"));
+}
+
+void RepositoryBench::recordSessionAdHoc()
+{
+    QSqlDatabase db = openAdHoc(dbPath());
+    QVERIFY(db.isOpen());
+
+    // Одна внешняя транзакция, чтобы в замер не попадал fsync
+    db.transaction();
+    QBENCHMARK {
+        QSqlQuery query(db);
+        query.prepare("INSERT INTO sessions (duration_minutes) VALUES (:duration)");
+        query.bindValue(":duration", 25);
+        query.exec();
+    }
+    db.rollback();
+    closeAdHoc(db);
+}
+
+void RepositoryBench::recordSessionCached()
+{
+    ProgressRepository repository(kRepositoryConnection);
+    QVERIFY(repository.open(dbPath()));
+
+    QVERIFY(repository.transaction());
+    QBENCHMARK {
+        repository.recordSession(25);
+    }
+    repository.rollback();
+}
+
+void RepositoryBench::sessionCountAdHoc()
+{
+    QSqlDatabase db = openAdHoc(dbPath());
+    QVERIFY(db.isOpen());
+
+    int count = 0;
+    QBENCHMARK {
+        QSqlQuery query(db);
+        if (query.exec("SELECT COUNT(*) FROM sessions") && query.next()) {
+            count = query.value(0).toInt();
+        }
+    }
+    QVERIFY(count >= 1000);
+    closeAdHoc(db);
+}
+
+void RepositoryBench::sessionCountCached()
+{
+    ProgressRepository repository(kRepositoryConnection);
+    QVERIFY(repository.open(dbPath()));
+
+    int count = 0;
+    QBENCHMARK {
+        count = repository.sessionCount();
+    }
+    QVERIFY(count >= 1000);
+}
@@ -0,0 +1,30 @@
+#ifndef REPOSITORYBENCH_H
+#define REPOSITORYBENCH_H
+
+#include <QObject>
+#include <QTemporaryDir>
+
+// Стоимость одного обращения к бд: разовый QSqlQuery с prepare на каждый вызов
+// (как было в главном окне) против закэшированных запросов ProgressRepository
+class RepositoryBench : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void getSettingAdHoc();
+    void getSettingCached();
+    void recordSessionAdHoc();
+    void recordSessionCached();
+    void sessionCountAdHoc();
+    void sessionCountCached();
+
+private:
+    QString dbPath() const;
+
+    QTemporaryDir m_dir;
+};
+
+#endif // REPOSITORYBENCH_H
@@ -0,0 +1,163 @@
+#include "themebench.h"
+#include "../headers/quotesdialog.h"
+#include "../headers/theme.h"
+#include <QtTest>
+#include <QApplication>
+#include <QComboBox>
+#include <QLabel>
+#include <QPushButton>
+#include <QSpinBox>
+#include <QVBoxLayout>
+
+namespace {
+
+constexpr int kQuotes = 1000;
+
+// Считает события, которыми Qt сопровождает пересчёт стиля и палитры виджетов
+class PolishCounter : public QObject
+{
+public:
+    PolishCounter() { qApp->installEventFilter(this); }
+    ~PolishCounter() override { qApp->removeEventFilter(this); }
+
+    int polish = 0;        // Polish и PolishRequest
+    int styleChange = 0;
+    int paletteChange = 0;
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override
+    {
+        switch (event->type()) {
+        case QEvent::Polish:
+        case QEvent::PolishRequest:
+            ++polish;
+            break;
+        case QEvent::StyleChange:
+            ++styleChange;
+            break;
+        case QEvent::PaletteChange:
+            ++paletteChange;
+            break;
+        default:
+            break;
+        }
+        return QObject::eventFilter(watched, event);
+    }
+};
+
+void report(const char *path, const PolishCounter &counter)
+{
+    qInfo().noquote() << QString("%1: polish %2, смен стиля %3, смен палитры %4 за переключение туда и обратно")
+                             .arg(path)
+                             .arg(counter.polish)
+                             .arg(counter.styleChange)
+                             .arg(counter.paletteChange);
+}
+
+} // namespace
+
+void ThemeBench::initTestCase()
+{
+    QStringList quotes;
+    quotes.reserve(kQuotes);
+    for (int i = 0; i < kQuotes; ++i) {
+        quotes.append(QString("Цитата номер %1: маленькие шаги каждый день складываются в большой результат").arg(i));
+    }
+    m_store.setQuotes(quotes);
+    m_store.setUnlockedCount(kQuotes / 2);
+
+    m_window.reset(new QWidget);
+    auto *layout = new QVBoxLayout(m_window.data());
+    m_timeLabel = new QLabel("25:00", m_window.data());
+    m_counterLabel = new QLabel("Сессий завершено: 0", m_window.data());
+    m_quoteLabel = new QLabel("Цитата", m_window.data());
+    layout->addWidget(m_timeLabel);
+    layout->addWidget(m_counterLabel);
+    layout->addWidget(m_quoteLabel);
+    layout->addWidget(new QPushButton("Старт", m_window.data()));
+    layout->addWidget(new QPushButton("Пауза", m_window.data()));
+    layout->addWidget(new QPushButton("Сброс", m_window.data()));
+    layout->addWidget(new QComboBox(m_window.data()));
+    layout->addWidget(new QSpinBox(m_window.data()));
+    m_window->show();
+
+    m_dialog.reset(new QuotesDialog(&m_store, &m_index, m_window.data()));
+    m_dialog->show();
+    QVERIFY(QTest::qWaitForWindowExposed(m_dialog.data()));
+}
+
+void ThemeBench::cleanupTestCase()
+{
+    m_dialog.reset();
+    m_window.reset();
+}
+
+void ThemeBench::cleanup()
+{
+    // Следующий замер начинается без таблиц стилей
+    qApp->setStyleSheet(QString());
+    m_timeLabel->setStyleSheet(QString());
+    m_counterLabel->setStyleSheet(QString());
+    m_quoteLabel->setStyleSheet(QString());
+    QCoreApplication::sendPostedEvents();
+}
+
+// Прежний Antiprocrastinator::applyTheme
+void ThemeBench::applyStyleSheets(bool dark)
+{
+    qApp->setPalette(dark ? Theme::dark().palette() : Theme::light().palette());
+    if (dark) {
+        m_timeLabel->setStyleSheet("QLabel { font-size: 72px; font-weight: bold; color: #4fc3f7; margin: 10px 0; }");
+        m_counterLabel->setStyleSheet("QLabel { font-size: 18px; color: #64b5f6; margin-bottom: 15px; }");
+        m_quoteLabel->setStyleSheet("QLabel { font-size: 16px; font-style: italic; color: #b0bec5; padding: 10px; min-height: 70px; }");
+        qApp->setStyleSheet("QToolTip { color: #ffffff; background-color: #2a2a2a; border: 1px solid white; padding: 5px; border-radius: 3px; }");
+    } else {
+        m_timeLabel->setStyleSheet("QLabel { font-size: 72px; font-weight: bold; color: #2c3e50; margin: 10px 0; }");
+        m_counterLabel->setStyleSheet("QLabel { font-size: 18px; color: #3498db; margin-bottom: 15px; }");
+        m_quoteLabel->setStyleSheet("QLabel { font-size: 16px; font-style: italic; color: #7f8c8d; padding: 10px; min-height: 70px; }");
+        qApp->setStyleSheet("QToolTip { color: #000000; background-color: #ffffff; border: 1px solid #bdc3c7; padding: 5px; border-radius: 3px; }");
+    }
+    // Отложенные события тоже часть стоимости переключения
+    QCoreApplication::sendPostedEvents();
+}
+
+// Текущий Antiprocrastinator::applyTheme
+void ThemeBench::applyTheme(const Theme &theme)
+{
+    Theme::apply(theme);
+    m_timeLabel->setPalette(theme.timePalette());
+    m_counterLabel->setPalette(theme.counterPalette());
+    m_quoteLabel->setPalette(theme.quotePalette());
+    QCoreApplication::sendPostedEvents();
+}
+
+void ThemeBench::switchWithStyleSheets()
+{
+    {
+        PolishCounter counter;
+        applyStyleSheets(true);
+        applyStyleSheets(false);
+        report("Таблицы стилей", counter);
+    }
+
+    QBENCHMARK {
+        applyStyleSheets(true);
+        applyStyleSheets(false);
+    }
+}
+
+void ThemeBench::switchWithThemes()
+{
+    {
+        PolishCounter counter;
+        applyTheme(Theme::dark());
+        applyTheme(Theme::light());
+        report("Объекты Theme", counter);
+        QCOMPARE(counter.styleChange, 0);
+    }
+
+    QBENCHMARK {
+        applyTheme(Theme::dark());
+        applyTheme(Theme::light());
+    }
+}
@@ -0,0 +1,43 @@
+#ifndef THEMEBENCH_H
+#define THEMEBENCH_H
+
+#include <QObject>
+#include <QWidget>
+#include <QScopedPointer>
+#include "../headers/quotestore.h"
+#include "../headers/quoteindex.h"
+
+class QLabel;
+class QuotesDialog;
+class Theme;
+
+// Переключение темы туда и обратно при открытой коллекции цитат:
+// прежний путь через таблицы стилей (qApp->setStyleSheet и стили меток)
+// против готовых объектов Theme, которые меняют только палитры.
+// Кроме времени, для каждого пути печатается число событий polish и смены стиля
+class ThemeBench : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void cleanup();
+
+    void switchWithStyleSheets();
+    void switchWithThemes();
+
+private:
+    void applyStyleSheets(bool dark);
+    void applyTheme(const Theme &theme);
+
+    QuoteStore                  m_store;
+    QuoteIndex                  m_index;
+    QScopedPointer<QWidget>      m_window;   // Те же виджеты, что в главном окне
+    QScopedPointer<QuotesDialog> m_dialog;
+    QLabel *m_timeLabel = nullptr;
+    QLabel *m_counterLabel = nullptr;
+    QLabel *m_quoteLabel = nullptr;
+};
+
+#endif // THEMEBENCH_H
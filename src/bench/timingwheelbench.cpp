@@ -0,0 +1,80 @@
+#include "timingwheelbench.h"
+#include "../headers/timingwheel.h"
+#include <QtTest>
+#include <QVector>
+#include <QRandomGenerator>
+
+namespace {
+
+constexpr int kTimers = 10000;
+constexpr int kTickMs = 1000;
+
+// Помодоро разной длины от 5 до 60 минут, как в настройках приложения
+qint64 randomDurationMs(QRandomGenerator &random)
+{
+    return qint64(random.bounded(5, 61)) * 60 * 1000;
+}
+
+} // namespace
+
+void TimingWheelBench::tickWith10kTimers()
+{
+    TimingWheel wheel(kTickMs);
+    QRandomGenerator random(42);
+
+    // Сработавший таймер сразу перезапускается, чтобы активных всегда было kTimers
+    connect(&wheel, &TimingWheel::expired, &wheel, [&wheel, &random]() {
+        wheel.start(randomDurationMs(random));
+    });
+    for (int i = 0; i < kTimers; ++i) {
+        wheel.start(randomDurationMs(random));
+    }
+
+    QBENCHMARK {
+        wheel.advance();
+    }
+    QCOMPARE(wheel.activeCount(), kTimers);
+}
+
+void TimingWheelBench::start10kTimers()
+{
+    QRandomGenerator random(42);
+    QBENCHMARK {
+        TimingWheel wheel(kTickMs);
+        for (int i = 0; i < kTimers; ++i) {
+            wheel.start(randomDurationMs(random));
+        }
+    }
+}
+
+void TimingWheelBench::pauseResume()
+{
+    TimingWheel wheel(kTickMs);
+    QRandomGenerator random(42);
+    QVector<TimingWheel::Handle> handles;
+    handles.reserve(kTimers);
+    for (int i = 0; i < kTimers; ++i) {
+        handles.append(wheel.start(randomDurationMs(random)));
+    }
+
+    int next = 0;
+    QBENCHMARK {
+        const TimingWheel::Handle handle = handles.at(next);
+        wheel.pause(handle);
+        wheel.resume(handle);
+        next = (next + 1) % kTimers;
+    }
+    QCOMPARE(wheel.activeCount(), kTimers);
+}
+
+void TimingWheelBench::cancel()
+{
+    TimingWheel wheel(kTickMs);
+    QRandomGenerator random(42);
+
+    QBENCHMARK {
+        const TimingWheel::Handle handle = wheel.start(randomDurationMs(random));
+        wheel.cancel(handle);
+    }
+    QCOMPARE(wheel.activeCount(), 0);
+}
@@ -0,0 +1,20 @@
+#ifndef TIMINGWHEELBENCH_H
+#define TIMINGWHEELBENCH_H
+
+#include <QObject>
+
+// Стоимость операций иерархического колеса таймеров при 10 000 активных таймеров:
+// один тик колеса (время CPU на тик для всех таймеров сразу), запуск,
+// пауза с продолжением и отмена
+class TimingWheelBench : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void tickWith10kTimers();
+    void start10kTimers();
+    void pauseResume();
+    void cancel();
+};
+
+#endif // TIMINGWHEELBENCH_H
@@ -0,0 +1,58 @@
+#include "tracebench.h"
+#include "benchdata.h"
+#include "../headers/trace.h"
+#include <QtTest>
+
+namespace {
+
+constexpr int kEventsPerThread = 65536;
+
+} // namespace
+
+void TraceBench::spanDisabled()
+{
+    QVERIFY(!Trace::isEnabled());
+    QBENCHMARK {
+        Trace::Span span("замер");
+    }
+}
+
+void TraceBench::counterDisabled()
+{
+    QVERIFY(!Trace::isEnabled());
+    qint64 value = 0;
+    QBENCHMARK {
+        Trace::counter("замер", ++value);
+    }
+}
+
+void TraceBench::spanEnabled()
+{
+    Trace::start(BenchData::tempPath("trace_span.json"), kEventsPerThread);
+    QBENCHMARK {
+        Trace::Span span("замер");
+    }
+    QVERIFY(Trace::finish());
+}
+
+void TraceBench::counterEnabled()
+{
+    Trace::start(BenchData::tempPath("trace_counter.json"), kEventsPerThread);
+    qint64 value = 0;
+    QBENCHMARK {
+        Trace::counter("замер", ++value);
+    }
+    QVERIFY(Trace::finish());
+}
+
+void TraceBench::finishFullBuffer()
+{
+    // Буфер потока заполнен целиком: выгружается kEventsPerThread событий
+    QBENCHMARK {
+        Trace::start(BenchData::tempPath("trace_full.json"), kEventsPerThread);
+        for (int i = 0; i < kEventsPerThread; ++i) {
+            Trace::Span span("замер");
+        }
+        Trace::finish();
+    }
+}
@@ -0,0 +1,21 @@
+#ifndef TRACEBENCH_H
+#define TRACEBENCH_H
+
+#include <QObject>
+
+// Цена трассировки на горячем пути: Span и counter при выключенной
+// трассировке (должна быть близка к нулю) и при включённой, с записью
+// в кольцевой буфер потока, а также выгрузка полного буфера в JSON
+class TraceBench : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void spanDisabled();
+    void counterDisabled();
+    void spanEnabled();
+    void counterEnabled();
+    void finishFullBuffer();
+};
+
+#endif // TRACEBENCH_H
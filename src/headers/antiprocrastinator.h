@@ -2,20 +2,52 @@
 #define ANTIPROCASTINATOR_H
 
 #include <QMainWindow>
-#include <QTimer>
-#include <QTime>
 #include <QLabel>
 #include <QPushButton>
 #include <QComboBox>
 #include <QSpinBox>
-#include <QList>
-#include <QPair>
-#include <QSqlDatabase>
-#include <QSqlQuery>
 #include <QDir>
 #include <QStandardPaths>
+#include <QFuture>
+#include <QPointer>
+#include <QHash>
+#include "quotestore.h"
+#include "quoteindex.h"
+#include "progressrepository.h"
+#include "profilestats.h"
+#include "startuptrace.h"
+#include "envconfig.h"
 
 class QuotesDialog;
+class TimerEngine;
+class PersistenceWorker;
+class SettingsStore;
+class Theme;
+class QuoteBanner;
+class QAction;
+class EnvConfigWatcher;
+class FileChangeWatcher;
+class SessionJournal;
+class CountdownDisplay;
+class QSystemTrayIcon;
+class QMenu;
+class ConnectionPool;
+
+// Прогресс и настройки профиля, прочитанные из бд в фоне при запуске и при переключении профиля
+struct StartupSnapshot {
+    QString profile;
+    bool    ok = false;
+    QString error;
+    int     sessionsCompleted = 0;
+    QVector<quint64> unlockedIds;         // Идентификаторы открытых цитат в порядке открытия
+    bool    unlocksMigrated = false;      // false — открытия ещё хранятся только числом сессий
+    QString theme;
+    bool    themeFound = false;
+    QString duration;
+    bool    durationFound = false;
+    qint64  journalCommittedKey = 0;      // Последняя сессия из журнала, уже записанная в sessions
+    ProgressRepository *repository = nullptr;   // Соединение главного потока, открытое в фоне и переданное ему
+};
 
 class Antiprocrastinator : public QMainWindow
 {
@@ -29,55 +61,116 @@ private slots:
     void startTimer();
     void pauseTimer();
     void resetTimer();
-    void updateDisplay();   // Вызывается каждую секунду, уменьшает счётчик и обновляет метку
-    void timerFinished();   // Сессия завершена: сохраняет в БД и открывает цитату
+    void updateDisplay();   // Передаёт табло оставшееся время из движка таймера
+    void timerFinished();   // Сессия завершена: ставит запись в очередь и открывает цитату
+    void onSessionRecorded(const QString &profile, int sessionId, qint64 journalKey);
+    void onWriteFailed(int commandType, const QString &error);
+    void onCountersRepaired(const QString &profile, int sessionCount);
+    void onConfigReloaded(const EnvConfig &config, const QStringList &changedKeys);   // Применяет изменённые ключи .env
+    void reloadQuotes();    // Файл цитат изменён: применяет разницу, сохраняя открытые цитаты
     void showMotivationalQuote();
     void changeTheme(int index);
     void changeDuration(int minutes);
     void showQuotesCollection();
+    void showStatistics();
+    void hideToTray();      // Прячет окно в системный трей: отсчёт идёт без посекундных пробуждений
+    void restoreFromTray();
+    void showWakeupReport();
+    void switchProfile(const QString &profile);   // Читает снимок нового профиля в фоне, интерфейс не блокируется
+    void createProfile();
+    void showProfilesSummary();   // Итоги всех профилей, собранные параллельно
+    void updateProfileMenu();
+
+protected:
+    void changeEvent(QEvent *event) override;
+    void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
 
 private:
-    bool initDatabase();            // Создаёт таблицы sessions и settings, если их нет
     void loadEnvironmentConfig();   // Читает .env: путь к цитатам, тема, длительность, путь к БД
-    void loadQuotes();              // Загружает цитаты из файла (с fallback на встроенный список)
-    void loadProgress();            // Восстанавливает количество сессий и открытые цитаты из БД
-    void saveProgress();            // Записывает тему и длительность в таблицу settings
-    void unlockQuoteForSession(int sessionId);
+    void loadQuotes();              // Загружает цитаты из файла (с fallback на встроенный список); в фоновом потоке
+    void applyDatabase(const StartupSnapshot &snapshot);   // Запускает поток записи и применяет прочитанные настройки
+    void applySnapshot(const StartupSnapshot &snapshot);   // Прогресс и настройки профиля в окно
+    void applyProfile(const StartupSnapshot &snapshot);    // Завершает переключение профиля
+    bool sessionInProgress() const;  // Сессия идёт или стоит на паузе: её нельзя перенести в другой профиль
+    void updateWindowTitle();
+    void finishStartupStage();      // Вызывается по готовности бд и цитат, после обоих завершает запуск
+    void setStartupControlsEnabled(bool enabled);
+    void loadProgress();            // Показывает открытые цитаты, когда готовы и бд, и цитаты
+    void recoverSession();          // Проигрывает журнал: дописывает потерянные сессии и восстанавливает прерванную
+    void commitSession(int durationMinutes, qint64 journalKey);   // Засчитывает сессию и ставит её в очередь записи
+    void applyPendingDuration();    // Ставит в поле длительность из .env, отложенную до конца сессии
+    void applyPendingQuotesFile();  // Перечитывает цитаты из файла, сменившегося в .env во время запуска
+    void saveProgress();            // Передаёт тему и длительность в хранилище настроек с отложенной записью
     void applyTheme(const QString &themeName);  // Переключает тему между темной и светлой
     void setupUI();
     void setupMenuBar();
+    void setupTray();
+    void updateWakePolicy();        // Выбирает частоту пробуждений таймера по видимости окна
+    QString wakeupSummary() const;  // Пробуждения таймера и их число в час отсчёта
 
     // Виджеты интерфейса
-    QLabel      *m_timeLabel;           // Отображает оставшееся время в формате MM:SS
+    CountdownDisplay *m_timeDisplay;    // Оставшееся время в формате MM:SS, перерисовываются только сменившиеся цифры
     QLabel      *m_sessionCounterLabel; // Показывает, сколько сессий завершено
-    QLabel      *m_quoteLabel;          // Область для мотивационных цитат
+    QuoteBanner *m_quoteBanner;         // Область для мотивационных цитат с анимацией появления
     QPushButton *m_startButton;
     QPushButton *m_pauseButton;
     QPushButton *m_resetButton;
     QComboBox   *m_themeComboBox;
     QSpinBox    *m_durationSpinBox;
+    QAction     *m_viewCollectionAction;
+    QAction     *m_viewStatsAction;
+    QMenu       *m_profileMenu = nullptr;
+    QAction     *m_profilesSummaryAction = nullptr;
+    QAction     *m_trayAction = nullptr;
+    QSystemTrayIcon *m_trayIcon = nullptr;   // nullptr, если в системе нет трея
 
     // Состояние таймера
-    QTimer *m_timer;
-    QTime   m_remainingTime;
-    int     m_pomodoroMinutes = 25;
-    bool    m_isRunning = false;
+    TimerEngine *m_engine;             // Отсчёт от монотонного дедлайна, без дрейфа
+    int          m_pomodoroMinutes = 25;
+    SessionJournal *m_journal = nullptr;   // Переходы таймера на диске на случай падения; только при доступной бд
+    QHash<QString, SessionJournal *> m_journals;   // У каждого профиля свой журнал рядом с его базой
+    qint64       m_journalCommittedKey = 0;
 
     // Данные о прогрессе
     int m_sessionsCompleted = 0;
 
-    QList<QString>              m_allQuotes;          // Все цитаты из файла
-    QList<QPair<QString, bool>> m_quotesWithStatus;   // Текст цитаты, открыта ли
-    int m_unlockedCount = 0;                          // Сколько цитат уже доступно пользователю
+    QuoteStore m_quotes;   // Все цитаты из файла и сколько из них уже открыто
+    QVector<quint64> m_unlockedIds;     // Открытые цитаты из бд, по ним восстанавливается m_quotes
+    bool       m_unlocksMigrated = true;
+    QuoteIndex m_quoteIndex;            // Поиск в коллекции; строится вместе с загрузкой цитат
+    bool       m_quotesReady = false;   // До этого m_quotes заполняется фоновым потоком
+    QString    m_quotesTextPath;        // Текстовый файл цитат, за которым следим; пусто — встроенный набор
+    FileChangeWatcher     *m_quotesFileWatcher = nullptr;
+    QPointer<QuotesDialog> m_quotesDialog;   // Открытая коллекция, если есть
+
+    // Поэтапный запуск: бд и цитаты загружаются параллельно
+    StartupTrace             m_trace;
+    QFuture<StartupSnapshot> m_databaseFuture;
+    QFuture<StartupSnapshot> m_profileFuture;    // Снимок профиля, на который переключаемся
+    QFuture<ProfileSummary>  m_summaryFuture;
+    QFuture<void>            m_quotesFuture;
+    int                      m_finishedStages = 0;
 
     // Конфигурация из .env
     QString m_quotesFilePath;
     QString m_defaultTheme;
     int     m_defaultDuration;
+    bool    m_defaultDurationPending = false;   // DEFAULT_DURATION сменился во время сессии
+    QString m_pendingQuotesFilePath;            // QUOTES_FILE_PATH, ещё не применённый
+    bool    m_quotesFilePathPending = false;
+    EnvConfigWatcher *m_configWatcher = nullptr;
+
+    const Theme *m_theme = nullptr;   // Применённая тема, общий неизменяемый объект
 
-    // База данных SQLite
-    QSqlDatabase m_db;
-    QString      m_dbPath;
+    // База данных SQLite: у каждого профиля свой шард. Соединения всех потоков
+    // выдаёт пул, а m_repository — соединение главного потока с текущим профилем
+    ConnectionPool     *m_pool = nullptr;
+    ProgressRepository *m_repository = nullptr;
+    QString            m_dbPath;
+    QString            m_profile;
+    PersistenceWorker *m_writer = nullptr;
+    SettingsStore     *m_settings = nullptr;   // Настройки в памяти, пишутся в бд пачками
 };
 
 #endif // ANTIPROCASTINATOR_H
\ No newline at end of file
@@ -0,0 +1,99 @@
+#ifndef CONNECTIONPOOL_H
+#define CONNECTIONPOOL_H
+
+#include <QHash>
+#include <QMetaObject>
+#include <QMutex>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QThreadPool>
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "progressrepository.h"
+
+class QThread;
+
+// Соединения с базами прогресса по профилям.
+// У каждого профиля своя база-шард: профиль по умолчанию живёт в DB_PATH,
+// остальные — в каталоге profiles рядом с ним, <имя>.db. Соединение QSqlDatabase
+// привязано к создавшему его потоку, поэтому пул хранит по одному
+// ProgressRepository на пару «профиль, поток» и отдаёт его повторно вместе
+// с кэшем подготовленных запросов. Переключение профиля в окне и фоновые
+// сводки не открывают и не закрывают базы заново, а только выбирают готовое
+// соединение. Фоновые чтения идут в собственном пуле потоков readers().
+// Соединение закрывается только в потоке-владельце: когда поток завершается,
+// явно через releaseThread или release, или при вытеснении — у потока не больше
+// kMaxConnectionsPerThread соединений, давно не использованное закрывается первым.
+// Схема создаётся один раз на профиль.
+class ConnectionPool
+{
+public:
+    static constexpr char kDefaultProfile[] = "default";
+    static constexpr int  kMaxProfileNameLength = 32;
+    static constexpr int  kMaxConnectionsPerThread = 8;
+
+    // Соединение главного потока может держать блокировку, поэтому по умолчанию ждём, а не падаем сразу
+    explicit ConnectionPool(const QString &defaultDbPath,
+                            const QString &connectOptions = "QSQLITE_BUSY_TIMEOUT=5000");
+    ~ConnectionPool();   // Закрывает все соединения, см. closeAll
+
+    ConnectionPool(const ConnectionPool &) = delete;
+    ConnectionPool &operator=(const ConnectionPool &) = delete;
+
+    // Буквы, цифры, '_' и '-', не длиннее kMaxProfileNameLength: имя становится именем файла
+    static bool isValidProfileName(const QString &name);
+
+    QString     shardPath(const QString &profile) const;
+    QStringList profiles() const;   // Профиль по умолчанию и все найденные шарды, по алфавиту
+
+    // Соединение текущего потока с базой профиля; открывается при первом
+    // обращении. created — соединение только что открыто. nullptr при ошибке.
+    // Указатель не стоит хранить дольше текущей задачи: следующие открытия
+    // этим потоком других профилей могут вытеснить соединение
+    ProgressRepository *acquire(const QString &profile, bool *created = nullptr, QString *error = nullptr);
+    // Соединение потока owner: открывается и получает схему в текущем потоке,
+    // а затем передаётся owner. Так главный поток получает готовое соединение,
+    // не дожидаясь открытия файла, PRAGMA и блокировок базы. Уже открытое возвращается сразу
+    ProgressRepository *acquireFor(const QString &profile, QThread *owner, QString *error = nullptr);
+
+    // Пул потоков для фоновых чтений через пул: снимки профилей и сводки
+    QThreadPool *readers() { return &m_readers; }
+
+    void releaseThread(QThread *thread);   // Закрывает соединения потока; вызывается из него самого
+    void releaseCurrentThread();
+    void release(const QString &profile);  // Закрывает соединение текущего потока с профилем
+    // Дожидается фоновых чтений и останавливает их потоки, которые закрывают
+    // свои соединения сами; затем закрывает соединения вызывающего потока.
+    // Другие потоки к этому моменту должны отпустить свои соединения
+    void closeAll();
+    int  connectionCount() const;
+
+private:
+    using Key = std::pair<QString, QThread *>;
+    struct Entry {
+        std::unique_ptr<ProgressRepository> repository;
+        quint64 lastUse = 0;   // Значение m_useClock при последней выдаче
+    };
+
+    ProgressRepository *openFor(const QString &profile, QThread *owner, bool *created, QString *error);
+    void evictLeastRecentlyUsed(QThread *thread, std::vector<std::unique_ptr<ProgressRepository>> *evicted);
+
+    QString m_defaultDbPath;
+    QString m_connectOptions;
+
+    mutable QMutex m_mutex;   // Защищает m_connections, m_threadWatches и m_useClock
+    std::map<Key, Entry>                      m_connections;
+    QHash<QThread *, QMetaObject::Connection> m_threadWatches;   // Подписки на QThread::finished
+    quint64 m_nextConnectionId = 0;
+    quint64 m_useClock = 0;
+
+    QMutex        m_schemaMutex;   // Первое открытие профиля создаёт схему, остальные ждут
+    QSet<QString> m_schemaReady;
+
+    QThreadPool m_readers;   // Объявлен последним: останавливается до того, как разрушатся соединения
+};
+
+#endif // CONNECTIONPOOL_H
@@ -0,0 +1,48 @@
+#ifndef COUNTDOWNDISPLAY_H
+#define COUNTDOWNDISPLAY_H
+
+#include <QWidget>
+#include <QPixmap>
+
+// Крупное табло обратного отсчёта в формате MM:SS.
+// Цифры и двоеточие один раз отрисовываются в атлас — QPixmap с ячейками на
+// фоне окна, по одному на сочетание цветов палитры, шрифта и масштаба экрана,
+// поэтому при возврате к прежней теме атлас берётся из QPixmapCache. Секунда
+// отсчёта копирует из атласа только ячейки, цифра в которых сменилась.
+// Размер табло зависит только от шрифта, поэтому смена времени, в отличие от
+// QLabel::setText, не вызывает updateGeometry и перекладку окна.
+// Цвет цифр — роль WindowText палитры, фон — роль Window.
+class CountdownDisplay : public QWidget
+{
+    Q_OBJECT
+
+public:
+    static constexpr int kCells = 5;     // Две цифры минут, двоеточие, две цифры секунд
+
+    explicit CountdownDisplay(QWidget *parent = nullptr);
+
+    void    setRemainingSeconds(int seconds);   // Помечает к перерисовке только сменившиеся ячейки
+    int     remainingSeconds() const { return m_seconds; }
+    QString text() const;                       // «MM:SS», для сообщений
+
+    QSize sizeHint() const override;
+    QSize minimumSizeHint() const override;
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void changeEvent(QEvent *event) override;
+
+private:
+    void  updateMetrics();       // Ширина ячеек по шрифту
+    bool  ensureAtlas();         // Достаёт атлас из кэша или рисует заново
+    QRect cellRect(int cell) const;
+
+    int     m_seconds = 0;
+    quint8  m_glyphs[kCells] = {0, 0, 10, 0, 0};   // Номер глифа в атласе: 0–9 — цифры, 10 — двоеточие
+    int     m_digitWidth = 0;
+    int     m_colonWidth = 0;
+    int     m_cellHeight = 0;
+    QPixmap m_atlas;             // Пусто — нужно достать или построить заново
+};
+
+#endif // COUNTDOWNDISPLAY_H
@@ -0,0 +1,71 @@
+#ifndef ENVCONFIG_H
+#define ENVCONFIG_H
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+// Настройки из .env-файла
+struct EnvConfig {
+    QString quotesFilePath = "quotes.txt";   // Путь к файлу цитат
+    QString defaultTheme = "light";          // light или dark
+    int     defaultDuration = 25;            // Длительность сессии в минутах
+    QString dbPath;                          // Путь к базе данных SQLite
+    QString profile = "default";             // Профиль при запуске; у каждого профиля своя база
+    QString tracePath;                       // Файл трассировки; пусто — трассировка выключена
+    int     traceBufferEvents = 65536;       // Ёмкость буфера трассировки на поток, событий
+    QString filePath;                        // Прочитанный .env; пусто, если файл не найден
+};
+
+// Описание ключа .env: имя, тип, допустимые значения и поле EnvConfig,
+// куда записывается проверенное значение. Значение по умолчанию — то,
+// которым поле инициализировано в EnvConfig
+struct ConfigKey {
+    enum Type {
+        Text,      // Произвольная непустая строка
+        Integer,   // Целое в диапазоне [minimum, maximum]
+        Choice,    // Одно из значений choices
+        Path       // Путь; обратные слеши приводятся к прямым
+    };
+
+    const char *name;
+    Type        type;
+    QString EnvConfig::*text = nullptr;     // Для Text, Choice и Path
+    int     EnvConfig::*number = nullptr;   // Для Integer
+    int         minimum = 0;
+    int         maximum = 0;
+    const char *choices = nullptr;          // Для Choice: варианты через '|'
+    bool        hotReload = false;          // Можно применить без перезапуска
+};
+
+// Ошибка в .env с номером строки (нумерация с 1)
+struct ConfigError {
+    int     line = 0;
+    QString message;
+};
+
+const QVector<ConfigKey> &envConfigSchema();
+
+// Ключ есть в схеме и помечен hotReload: его изменение применяется без перезапуска
+bool isHotReloadConfigKey(const QString &name);
+
+// Разбирает содержимое .env за один проход без регулярных выражений.
+// Строки с ошибками пропускаются: соответствующие ключи сохраняют значение
+// по умолчанию, а описание ошибки с номером строки попадает в errors
+EnvConfig parseEnvConfig(const QByteArray &data, QList<ConfigError> *errors = nullptr);
+
+// Имена ключей схемы, значения которых различаются
+QStringList changedConfigKeys(const EnvConfig &before, const EnvConfig &after);
+
+// Ищет .env рядом с исполняемым файлом или в текущей директории
+QString findEnvFile();
+
+// Читает найденный .env и пишет ошибки в лог. Ключи, которых нет в файле,
+// остаются со значениями по умолчанию. Относительные DB_PATH и TRACE_PATH отсчитываются
+// от домашней директории. Заодно создаёт директорию для бд, чтобы SQLite не упал при открытии.
+EnvConfig loadEnvConfig(QList<ConfigError> *errors = nullptr);
+EnvConfig loadEnvConfig(const QString &envFile, QList<ConfigError> *errors);
+
+#endif // ENVCONFIG_H
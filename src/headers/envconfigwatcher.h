@@ -0,0 +1,33 @@
+#ifndef ENVCONFIGWATCHER_H
+#define ENVCONFIGWATCHER_H
+
+#include <QObject>
+#include <QStringList>
+#include "envconfig.h"
+
+class FileChangeWatcher;
+
+// Следит за .env и перечитывает его после изменения. Сигнал reloaded
+// получает новую конфигурацию и список ключей, значения которых изменились;
+// применять ли их сразу, получатель решает по схеме (isHotReloadConfigKey).
+class EnvConfigWatcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit EnvConfigWatcher(const EnvConfig &initial, QObject *parent = nullptr);
+
+    const EnvConfig &config() const { return m_config; }
+
+signals:
+    void reloaded(const EnvConfig &config, const QStringList &changedKeys);
+
+private slots:
+    void reload();
+
+private:
+    EnvConfig          m_config;
+    FileChangeWatcher *m_watcher;
+};
+
+#endif // ENVCONFIGWATCHER_H
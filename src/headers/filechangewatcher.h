@@ -0,0 +1,44 @@
+#ifndef FILECHANGEWATCHER_H
+#define FILECHANGEWATCHER_H
+
+#include <QObject>
+#include <QDateTime>
+#include <QString>
+
+class QFileSystemWatcher;
+class QTimer;
+
+// Следит за одним файлом и сообщает о его изменении, когда запись затихла.
+// Наблюдает и за директорией: многие редакторы сохраняют файл, заменяя его
+// новым, и наблюдение за самим файлом при этом теряется. Изменения соседних
+// файлов отсеиваются по времени изменения и размеру.
+class FileChangeWatcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int kSettleMs = 100;   // Редакторы пишут файл в несколько приёмов
+
+    explicit FileChangeWatcher(QObject *parent = nullptr);
+
+    void    setFilePath(const QString &path);   // Пустой путь — перестать следить
+    QString filePath() const { return m_path; }
+
+signals:
+    void changed();
+
+private slots:
+    void scheduleCheck();
+    void check();
+
+private:
+    void watch();
+
+    QFileSystemWatcher *m_watcher;
+    QTimer             *m_settleTimer;
+    QString             m_path;
+    QDateTime           m_lastModified;
+    qint64              m_lastSize = -1;
+};
+
+#endif // FILECHANGEWATCHER_H
@@ -0,0 +1,71 @@
+#ifndef PERSISTENCEWORKER_H
+#define PERSISTENCEWORKER_H
+
+#include <QObject>
+#include <QMutex>
+#include <QQueue>
+#include <QList>
+#include <QPair>
+#include <QVector>
+#include <QString>
+#include "progressrepository.h"
+
+class QThread;
+class ConnectionPool;
+
+// Команда записи в базу прогресса
+struct WriteCommand {
+    enum Type {
+        RecordSession,   // Вставить завершённую сессию в sessions
+        SaveSettings,    // Обновить ключи в таблице settings
+        MigrateUnlocks   // Разово перенести открытые цитаты из старого формата
+    };
+
+    Type type = RecordSession;
+    QString profile;                           // Профиль, в чью базу пишется команда; пусто — профиль потока записи
+    int  durationMinutes = 0;                  // Для RecordSession
+    bool unlocksQuote = false;                 // Для RecordSession: сессия открыла цитату quoteId
+    quint64 quoteId = 0;
+    qint64  journalKey = 0;                    // Для RecordSession: ключ сессии в журнале, 0 — без журнала
+    QList<QPair<QString, QString>> settings;   // Для SaveSettings: ключ и значение
+    QVector<quint64> quoteIds;                 // Для MigrateUnlocks: в порядке открытия
+};
+
+// Запись прогресса в SQLite в отдельном потоке.
+// Поток интерфейса только кладёт команды в очередь и сразу возвращается,
+// а поток записи выполняет их на собственных соединениях из пула, по одному
+// на профиль, и сообщает результат сигналами. Деструктор дописывает очередь до конца.
+class PersistenceWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    // profile — профиль команд без явного профиля; его база открывается сразу
+    PersistenceWorker(ConnectionPool *pool, const QString &profile, QObject *parent = nullptr);
+    ~PersistenceWorker() override;
+
+    void enqueue(const WriteCommand &command);   // Потокобезопасно и не блокирует
+    void openProfile(const QString &profile);    // Заранее открывает базу профиля и сверяет её счётчики
+
+signals:
+    void sessionRecorded(const QString &profile, int sessionId, qint64 journalKey);
+    void settingsSaved();
+    void countersRepaired(const QString &profile, int sessionCount);   // Счётчик сессий пересобран по фактической таблице
+    void writeFailed(int commandType, const QString &error);   // commandType — WriteCommand::Type
+
+private:
+    // Выполняются только в потоке записи
+    ProgressRepository *connection(const QString &profile, QString *error = nullptr);
+    void drain();                       // Выполняет все накопившиеся команды
+    bool execute(const WriteCommand &command, int *sessionId, QString *error);
+
+    ConnectionPool *m_pool;             // Соединения потока записи с кэшем подготовленных запросов
+    QString         m_profile;
+    QThread *m_thread;
+    QObject *m_context;                 // Живёт в потоке записи, через него туда ставятся вызовы
+
+    QMutex               m_mutex;       // Защищает m_queue
+    QQueue<WriteCommand> m_queue;
+};
+
+#endif // PERSISTENCEWORKER_H
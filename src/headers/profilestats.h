@@ -0,0 +1,42 @@
+#ifndef PROFILESTATS_H
+#define PROFILESTATS_H
+
+#include <QDate>
+#include <QFuture>
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include "progressrepository.h"
+
+class ConnectionPool;
+
+// Итоги одного профиля для сводки по всем профилям
+struct ProfileSummary {
+    QString      profile;
+    bool         ok = false;
+    QString      error;
+    int          sessions = 0;   // Всего, из счётчика
+    StatsRow     today;
+    StatsRow     week;           // С понедельника по сегодня
+    StatsRow     total;
+    StatsStreaks streaks;
+};
+
+// Сводка по профилям. Каждый профиль — отдельный файл SQLite, поэтому
+// запросы к ним независимы и выполняются параллельно в пуле потоков чтения
+// ConnectionPool::readers(): каждый поток берёт собственное соединение с шардом,
+// а следующие сводки переиспользуют его вместе с подготовленными запросами.
+// Время сводки определяет самый большой шард, а не сумма всех.
+namespace ProfileStats {
+
+ProfileSummary summarize(ConnectionPool *pool, const QString &profile, const QDate &today);
+
+// Итоги в порядке profiles; не блокирует вызывающий поток
+QFuture<ProfileSummary> collect(ConnectionPool *pool, const QStringList &profiles, const QDate &today);
+
+// Сумма по доступным профилям; серии берутся лучшие
+ProfileSummary combine(const QList<ProfileSummary> &summaries);
+
+} // namespace ProfileStats
+
+#endif // PROFILESTATS_H
@@ -0,0 +1,121 @@
+#ifndef PROGRESSREPOSITORY_H
+#define PROGRESSREPOSITORY_H
+
+#include <QString>
+#include <QDate>
+#include <QList>
+#include <QVector>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+
+class QThread;
+
+// Период агрегирования статистики
+enum class StatsPeriod {
+    Day,
+    Week,    // Неделя начинается с понедельника
+    Month
+};
+
+// Одна строка свёртки: начало периода, число сессий и минут фокуса
+struct StatsRow {
+    QDate periodStart;
+    int   sessions = 0;
+    int   minutes = 0;
+};
+
+// Серии дней подряд хотя бы с одной сессией
+struct StatsStreaks {
+    int current = 0;   // Заканчивается сегодня или вчера
+    int longest = 0;
+};
+
+// Типизированный доступ к базе прогресса.
+// Владеет именованным соединением и кэширует подготовленные запросы:
+// каждый SQL-текст разбирается SQLite один раз за время жизни соединения,
+// дальше запрос только заново связывается с параметрами и выполняется.
+// Соединение, как и любое QSqlDatabase, используется только из потока,
+// в котором был вызван open(), или из того, которому его передал moveToThread().
+class ProgressRepository
+{
+public:
+    explicit ProgressRepository(const QString &connectionName);
+    ~ProgressRepository();
+
+    ProgressRepository(const ProgressRepository &) = delete;
+    ProgressRepository &operator=(const ProgressRepository &) = delete;
+
+    bool open(const QString &dbPath, const QString &connectOptions = QString());
+    void close();
+    // Передаёт соединение другому потоку; вызывается из текущего владельца.
+    // Подготовленные запросы сбрасываются и в новом потоке готовятся заново
+    bool moveToThread(QThread *thread);
+    bool isOpen() const { return m_db.isOpen(); }
+    QSqlDatabase database() const { return m_db; }           // Для потоковых запросов вне кэша
+
+    bool initSchema();                                        // Создаёт таблицы и триггеры, если их нет
+    bool verifyCounters(bool *repaired = nullptr);            // Сверяет счётчик и свёртки с sessions и чинит расхождение
+    void seedSettings(const QString &theme, int duration);    // Начальные значения без перезаписи
+    bool exec(const QString &sql);                            // Разовый запрос, например PRAGMA
+
+    bool transaction();
+    bool commit();
+    void rollback();
+
+    int     recordSession(int durationMinutes);               // id новой сессии или -1
+    // Связывает цитату (её QuotePack::quoteId) с открывшей её сессией.
+    // Повторное открытие той же цитаты не меняет исходную запись
+    bool    unlockQuoteForSession(int sessionId, quint64 quoteId);
+    QVector<quint64> unlockedQuoteIds();                      // В порядке открытия
+    bool    unlocksMigrated();                                // Открытия уже хранятся по идентификаторам
+    // Разовый перенос открытий из времён, когда хранилось только число сессий:
+    // i-я цитата считается открытой i-й по порядку сессией
+    bool    migrateLegacyUnlocks(const QVector<quint64> &quoteIds);
+    QString getSetting(const QString &key, const QString &defaultValue = QString(),
+                       bool *found = nullptr);
+    bool    setSetting(const QString &key, const QString &value);
+    int     sessionCount();                                   // O(1): читает счётчик, а не COUNT(*)
+    qint64  getCounter(const QString &name, bool *found = nullptr);
+    bool    setCounter(const QString &name, qint64 value);
+
+    // Статистика читается из свёрток stats_daily/stats_weekly/stats_monthly,
+    // которые триггеры обновляют при каждой вставке сессии
+    QList<StatsRow> statsRows(StatsPeriod period, const QDate &from, const QDate &to);
+    StatsRow        statsTotal(const QDate &from, const QDate &to);   // Сумма за диапазон дней
+    StatsStreaks    streaks(const QDate &today);
+
+    QString lastError() const { return m_lastError; }
+
+private:
+    enum Statement {
+        InsertSession,
+        SelectSetting,
+        UpsertSetting,
+        SeedSetting,
+        SelectCounter,
+        SelectStatsDaily,
+        SelectStatsWeekly,
+        SelectStatsMonthly,
+        SelectStatsTotal,
+        SelectActiveDays,
+        InsertUnlockedQuote,
+        SelectUnlockedQuotes,
+        UpsertCounter,
+        StatementCount
+    };
+
+    bool       initStatsSchema();         // Таблицы свёрток, их триггеры и разовое заполнение
+    bool       initUnlocksSchema();       // Таблица открытых цитат и её триггер
+    bool       rebuildRollups();          // Пересчитывает все свёртки по sessions; вызывается в транзакции
+    void       releaseStatements();       // Отпускает подготовленные запросы: они держат драйвер
+    QSqlQuery *statement(Statement id);   // Подготавливает запрос при первом обращении
+    bool       run(QSqlQuery *query);     // Выполняет и запоминает ошибку
+
+    QString      m_connectionName;
+    QSqlDatabase m_db;
+    QSqlQuery    m_statements[StatementCount];
+    bool         m_prepared[StatementCount] = {};
+    QString      m_lastError;
+};
+
+#endif // PROGRESSREPOSITORY_H
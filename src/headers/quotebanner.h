@@ -0,0 +1,88 @@
+#ifndef QUOTEBANNER_H
+#define QUOTEBANNER_H
+
+#include <QWidget>
+#include <QColor>
+#include <QStaticText>
+
+class QPropertyAnimation;
+class QTimer;
+class Theme;
+
+// Область с цитатой под таймером. Сама рисует текст и подложку в paintEvent,
+// а появление новой цитаты анимирует цветом и прозрачностью через
+// QPropertyAnimation. Таблиц стилей нет, поэтому кадр анимации — это только
+// перерисовка, без разбора CSS и пересчёта геометрии.
+class QuoteBanner : public QWidget
+{
+    Q_OBJECT
+    Q_PROPERTY(qreal highlight READ highlight WRITE setHighlight)
+    Q_PROPERTY(qreal textOpacity READ textOpacity WRITE setTextOpacity)
+
+public:
+    // Этапы анимации: вспышка «открыта новая цитата», показ цитаты с подсветкой
+    // и затухание подсветки. Паузы между ними — отдельные состояния
+    enum class State {
+        Idle,
+        Announcing,
+        AnnounceHold,
+        Revealing,
+        RevealHold,
+        Fading
+    };
+
+    explicit QuoteBanner(QWidget *parent = nullptr);
+
+    void setText(const QString &text);      // Показывает текст без анимации, прерывая текущую
+    void reveal(const QString &quote);      // Запускает анимацию заново, даже если идёт предыдущая
+    void cancel();                          // Сразу переходит к итоговому виду
+    void setTheme(const Theme &theme);
+
+    State  state() const { return m_state; }
+    QString text() const { return m_text; }
+
+    qreal highlight() const { return m_highlight; }
+    void  setHighlight(qreal value);
+    qreal textOpacity() const { return m_textOpacity; }
+    void  setTextOpacity(qreal value);
+
+    bool  hasHeightForWidth() const override { return true; }
+    int   heightForWidth(int width) const override;
+    QSize sizeHint() const override;
+    QSize minimumSizeHint() const override;
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+    void changeEvent(QEvent *event) override;
+
+private slots:
+    void advance();                         // Переход к следующему состоянию
+
+private:
+    void enterState(State state);
+    void animate(const QByteArray &property, qreal from, qreal to, int durationMs);
+    void showText(const QString &text);
+    void prepareText();
+
+    QPropertyAnimation *m_animation;
+    QTimer             *m_holdTimer;
+    State               m_state = State::Idle;
+
+    QString     m_text;
+    QString     m_pendingQuote;             // Цитата, которая сменит объявление
+    QStaticText m_staticText;               // Раскладка текста кэшируется между кадрами
+
+    qreal m_highlight = 0.0;                // 0 — обычный вид, 1 — полная подсветка
+    qreal m_textOpacity = 1.0;
+
+    QColor m_textColor;
+    QColor m_accentText;
+    QColor m_accentBackground;
+    QColor m_revealText;
+    QColor m_revealBackground;
+    QColor m_highlightText;
+    QColor m_highlightBackground;
+};
+
+#endif // QUOTEBANNER_H
@@ -0,0 +1,40 @@
+#ifndef QUOTEINDEX_H
+#define QUOTEINDEX_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+class QuoteStore;
+
+// Обратный индекс для поиска по коллекции цитат.
+// Текст режется на слова по правилам Unicode (QTextBoundaryFinder), слова
+// приводятся к свёрнутому регистру, «ё» приравнивается к «е». Словарь хранится
+// отсортированным, а списки номеров цитат для всех слов лежат подряд в одном
+// массиве, поэтому поиск по префиксу — двоичный поиск плюс проход по
+// смежному участку памяти, без обхода самой коллекции.
+// Индекс ссылается на цитаты по номерам и после перезагрузки файла строится заново.
+class QuoteIndex
+{
+public:
+    void build(const QuoteStore &store);   // O(размер коллекции), можно вызывать в фоновом потоке
+    void clear();
+    bool isBuilt() const { return m_built; }
+
+    int termCount() const { return int(m_terms.size()); }
+
+    // Номера цитат по возрастанию, в которых для каждого слова запроса есть
+    // слово, начинающееся с него. Пустой запрос ничего не находит
+    QVector<int> search(const QString &query) const;
+
+    static QStringList tokenize(const QString &text);   // Слова в свёрнутом регистре
+
+private:
+    QStringList  m_terms;       // Уникальные слова по возрастанию
+    QVector<int> m_termStart;   // Начало списка слова i в m_postings; размер на 1 больше словаря
+    QVector<int> m_postings;    // Номера цитат, для каждого слова по возрастанию
+    int          m_quoteCount = 0;
+    bool         m_built = false;
+};
+
+#endif // QUOTEINDEX_H
@@ -0,0 +1,92 @@
+#ifndef QUOTEPACK_H
+#define QUOTEPACK_H
+
+#include <QtGlobal>
+#include <QtEndian>
+
+// Бинарный формат скомпилированной коллекции цитат (.qpack).
+// Файл собирается утилитой quotepacker при сборке и читается через mmap без разбора:
+// доступ к любой цитате по номеру — O(1), поиск по идентификатору — O(log n).
+// Все числа хранятся в little-endian.
+//
+//   Заголовок, 32 байта
+//     char[4]  magic        "QPAK"
+//     quint16  version      kVersion
+//     quint16  headerSize   kHeaderSize
+//     quint32  count        количество цитат
+//     quint32  tableOffset  смещение таблицы записей от начала файла
+//     quint32  blobOffset   смещение блока текстов от начала файла
+//     quint32  blobSize     размер блока текстов в байтах
+//     quint32  checksum     CRC-32 таблицы записей, индекса и блока текстов
+//     quint32  idIndexOffset  смещение индекса по идентификаторам (с версии 2; в версии 1 — 0)
+//   Таблица записей, count × kEntrySize байт
+//     quint64  id           стабильный идентификатор цитаты, quoteId() от текста
+//     quint32  offset       смещение текста от начала блока текстов
+//     quint32  length       длина текста в байтах
+//   Индекс по идентификаторам, count × quint32 — номера записей, упорядоченные по id
+//   Блок текстов — UTF-8 подряд, без разделителей
+namespace QuotePack {
+
+constexpr char    kMagic[4] = {'Q', 'P', 'A', 'K'};
+constexpr quint16 kVersion = 2;
+constexpr quint16 kMinVersion = 1;   // Пакеты версии 1 читаются, но без индекса по id
+constexpr int     kHeaderSize = 32;
+constexpr int     kEntrySize = 16;
+
+// Смещения полей заголовка
+constexpr int kVersionField = 4;
+constexpr int kHeaderSizeField = 6;
+constexpr int kCountField = 8;
+constexpr int kTableOffsetField = 12;
+constexpr int kBlobOffsetField = 16;
+constexpr int kBlobSizeField = 20;
+constexpr int kChecksumField = 24;
+constexpr int kIdIndexOffsetField = 28;
+
+// Смещения полей записи
+constexpr int kEntryIdField = 0;
+constexpr int kEntryOffsetField = 8;
+constexpr int kEntryLengthField = 12;
+
+// Стабильный идентификатор цитаты: FNV-1a 64 от её текста в UTF-8.
+// Не зависит от позиции строки в файле, поэтому переживает перестановки
+inline quint64 quoteId(const char *data, qsizetype size)
+{
+    quint64 hash = 14695981039346656037ULL;
+    for (qsizetype i = 0; i < size; ++i) {
+        hash ^= quint8(data[i]);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+struct Crc32Table {
+    quint32 values[256];
+
+    constexpr Crc32Table() : values()
+    {
+        for (quint32 i = 0; i < 256; ++i) {
+            quint32 c = i;
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            values[i] = c;
+        }
+    }
+};
+
+inline constexpr Crc32Table kCrc32Table{};
+
+// CRC-32 (IEEE 802.3). Можно считать по частям, передавая предыдущий результат в crc
+inline quint32 crc32(const uchar *data, qsizetype size, quint32 crc = 0)
+{
+    crc = ~crc;
+    for (qsizetype i = 0; i < size; ++i) {
+        crc = kCrc32Table.values[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+} // namespace QuotePack
+
+#endif // QUOTEPACK_H
@@ -0,0 +1,17 @@
+#ifndef QUOTEPACKWRITER_H
+#define QUOTEPACKWRITER_H
+
+#include <QString>
+
+class QuoteStore;
+
+namespace QuotePack {
+
+// Записывает коллекцию в пакет .qpack текущей версии (см. quotepack.h).
+// Файл подменяется атомарно через QSaveFile. При ошибке возвращает false
+// и описание в error
+bool write(const QuoteStore &store, const QString &path, QString *error = nullptr);
+
+} // namespace QuotePack
+
+#endif // QUOTEPACKWRITER_H
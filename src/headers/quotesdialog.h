@@ -2,34 +2,42 @@
 #define QUOTESDIALOG_H
 
 #include <QDialog>
-#include <QPair>
-#include <QString>
-#include <QList>
 
 class QLabel;
-
-// Один элемент списка коллекции: иконка статуса + текст цитаты (или заглушка)
-class QuoteItem : public QWidget {
-    Q_OBJECT
-public:
-    explicit QuoteItem(const QString &text, bool unlocked, QWidget *parent = nullptr);
-
-protected:
-    // Нужен для корректной отрисовки QSS-стилей на кастомном QWidget
-    void paintEvent(QPaintEvent *event) override;
-};
-
-// Диалоговое окно с прокручиваемым списком всех цитат и счётчиком прогресса
+class QLineEdit;
+class QListView;
+class QuoteIndex;
+class QuoteStore;
+class QuotesModel;
+struct QuoteDiff;
+
+// Диалоговое окно с прокручиваемым списком всех цитат и счётчиком прогресса.
+// Список построен на модели и делегате, поэтому стоимость открытия не зависит
+// от размера коллекции: отрисовываются только видимые строки.
+// Поле поиска фильтрует открытые цитаты на каждое нажатие клавиши по обратному индексу.
 class QuotesDialog : public QDialog {
     Q_OBJECT
 public:
-    // quotes — список пар (текст цитаты, открыта ли), передаётся из главного окна
-    explicit QuotesDialog(const QList<QPair<QString, bool>> &quotes, QWidget *parent = nullptr);
+    // store — хранилище цитат главного окна, диалог только читает его.
+    // index — поисковый индекс того же хранилища; если он ещё не построен
+    // или сброшен перезагрузкой, диалог строит его при первом поиске
+    QuotesDialog(const QuoteStore *store, QuoteIndex *index, QWidget *parent = nullptr);
 
-private:
-    void setupUI(const QList<QPair<QString, bool>> &quotes);
+    // Файл цитат перечитан, пока диалог открыт: обновляются только изменившиеся строки
+    void quotesReloaded(const QuoteDiff &diff);
 
-    QLabel *m_progressLabel; // Заголовок «Открыто X из N цитат»
+private:
+    void setupUI();
+    void updateProgress();
+    void applySearch();   // Фильтрует список по тексту поля поиска
+
+    const QuoteStore *m_store;
+    QuoteIndex       *m_index;
+    QuotesModel      *m_model;
+    QLineEdit        *m_searchEdit;
+    QListView        *m_listView;
+    QLabel           *m_progressLabel; // Заголовок «Открыто X из N цитат»
+    QLabel           *m_statsLabel;    // Процент прохождения коллекции
 };
 
-#endif // QUOTESDIALOG_H
\ No newline at end of file
+#endif // QUOTESDIALOG_H
@@ -0,0 +1,59 @@
+#ifndef QUOTESMODEL_H
+#define QUOTESMODEL_H
+
+#include <QAbstractListModel>
+#include <QStyledItemDelegate>
+#include <QVector>
+
+class QuoteStore;
+struct QuoteDiff;
+
+// Модель коллекции поверх QuoteStore: строки не копируются,
+// текст запрашивается у хранилища только для видимых элементов.
+// Фильтр — готовый список номеров цитат от поиска, модель его не вычисляет
+class QuotesModel : public QAbstractListModel {
+    Q_OBJECT
+public:
+    enum Roles {
+        UnlockedRole = Qt::UserRole + 1   // bool: открыта ли цитата
+    };
+
+    explicit QuotesModel(const QuoteStore *store, QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+    // Хранилище уже перезагружено: сообщает представлениям только о заменённых строках
+    void applyDiff(const QuoteDiff &diff);
+
+    void setFilter(const QVector<int> &quotes);   // Показывать только эти цитаты, по возрастанию
+    void clearFilter();
+    bool isFiltered() const { return m_filtered; }
+
+private:
+    const QuoteStore *m_store;
+    int               m_rowCount;   // Число строк, о котором знают представления
+    bool              m_filtered = false;
+    QVector<int>      m_filter;     // Номер цитаты для каждой строки при включённом фильтре
+};
+
+// Рисует карточку цитаты: круглый значок статуса и перенесённый по словам текст.
+// Высота строки фиксирована, чтобы QListView мог работать с uniformItemSizes
+// и не измерял каждую строку коллекции.
+class QuoteDelegate : public QStyledItemDelegate {
+    Q_OBJECT
+public:
+    explicit QuoteDelegate(QObject *parent = nullptr);
+
+    void paint(QPainter *painter, const QStyleOptionViewItem &option,
+               const QModelIndex &index) const override;
+    QSize sizeHint(const QStyleOptionViewItem &option,
+                   const QModelIndex &index) const override;
+
+private:
+    QFont m_badgeFont;
+    QFont m_textFont;
+    int   m_rowHeight;   // Высота карточки: до трёх строк текста плюс отступы
+};
+
+#endif // QUOTESMODEL_H
@@ -0,0 +1,95 @@
+#ifndef QUOTESTORE_H
+#define QUOTESTORE_H
+
+#include <QFile>
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QBitArray>
+#include <QHash>
+#include <QVector>
+#include <memory>
+
+// Изменение коллекции после перезагрузки файла: строки [first, first + removed)
+// старой версии заменены строками [first, first + inserted) новой.
+// Всё до first и после заменённого участка совпадает по содержимому
+struct QuoteDiff {
+    int first = 0;
+    int removed = 0;
+    int inserted = 0;
+
+    bool isEmpty() const { return removed == 0 && inserted == 0; }
+};
+
+// Хранилище цитат и их статуса открытия.
+// Источник отображается в память, а хранилище держит только компактный индекс
+// (смещение и длина каждой строки). В QString строка декодируется лишь тогда,
+// когда её действительно показывают, поэтому время запуска и потребление памяти
+// почти не зависят от размера коллекции.
+// Для скомпилированного пакета .qpack индекс не строится вовсе: записи читаются
+// прямо из таблицы внутри отображённого файла.
+// Статус открытия — бит на каждую запись. При перезагрузке файла он
+// переносится по идентификатору содержимого, поэтому открытая цитата
+// остаётся открытой, даже если строки переставили или дописали новые.
+// Открытые цитаты восстанавливаются из бд по идентификаторам через indexOf:
+// двоичный поиск по индексу пакета или хеш-таблица для текстового источника.
+class QuoteStore
+{
+public:
+    bool loadFile(const QString &path);     // Отображает текстовый файл в память и строит индекс строк
+    bool loadPack(const QString &path);     // Отображает пакет .qpack, проверив заголовок, контрольную сумму и границы записей
+    void setQuotes(const QStringList &quotes);
+
+    // Перечитывает текстовый файл и сравнивает его с текущим содержимым по
+    // идентификаторам строк. Общие начало и конец не трогаются, статус открытия
+    // заменённого участка переносится по идентификатору. При ошибке чтения
+    // содержимое не меняется и возвращается false
+    bool reloadFile(const QString &path, QuoteDiff *diff);
+
+    int     size() const { return m_count; }
+    bool    isEmpty() const { return m_count == 0; }
+    QString text(int index) const;          // Декодирует UTF-8 по требованию
+    QByteArrayView bytes(int index) const;  // Байты строки как в источнике, без декодирования
+    quint64 id(int index) const;            // Стабильный идентификатор, см. QuotePack::quoteId
+    int     indexOf(quint64 id) const;      // Номер цитаты с этим идентификатором или -1
+
+    bool isUnlocked(int index) const { return m_unlocked.testBit(index); }
+    int  unlockedCount() const { return m_unlockedCount; }
+    void setUnlockedCount(int count);   // Открывает первые count цитат (не больше размера коллекции)
+    int  unlockNext();                  // Открывает первую закрытую, повторы строк пропускает; -1, если закрытых не осталось
+    // Открывает цитаты по идентификаторам в порядке открытия, последняя найденная
+    // становится lastUnlocked(). Идентификаторы, которых нет в коллекции, пропускаются.
+    // Возвращает число найденных цитат
+    int  setUnlockedIds(const QVector<quint64> &ids);
+    int  lastUnlocked() const { return m_lastUnlocked; }   // Последняя открытая цитата или -1
+
+private:
+    struct Entry {
+        quint32 offset;   // Смещение начала строки от начала данных
+        quint32 length;   // Длина строки в байтах UTF-8 без обрамляющих пробелов
+    };
+
+    void  clear();
+    void  buildIndex();
+    void  buildIds();                       // Идентификаторы всех строк текстового источника
+    void  takeContents(QuoteStore &other);  // Забирает данные и индекс, статус открытия не трогает
+    void  fitUnlocked();                    // Подгоняет биты открытия под новый размер
+    Entry entryAt(int index) const;
+
+    std::unique_ptr<QFile> m_file = std::make_unique<QFile>();   // Открыт, пока живёт отображение в память
+    QByteArray     m_buffer;     // Данные в памяти, если mmap недоступен или цитаты встроенные
+    const char    *m_data = nullptr;
+    qint64         m_dataSize = 0;
+    const uchar   *m_packTable = nullptr;   // Таблица записей .qpack, если загружен пакет
+    const uchar   *m_packIdIndex = nullptr; // Номера записей .qpack, упорядоченные по id (с версии 2)
+    QVector<Entry> m_index;                 // Индекс строк текстового источника
+    QVector<quint64> m_ids;                 // Кэш идентификаторов, заполняется при перезагрузке
+    mutable QHash<quint64, int> m_idLookup; // id -> номер, строится при первом indexOf без индекса пакета
+    int            m_count = 0;
+    QBitArray      m_unlocked;
+    int            m_unlockedCount = 0;
+    int            m_lastUnlocked = -1;
+};
+
+#endif // QUOTESTORE_H
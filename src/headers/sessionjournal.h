@@ -0,0 +1,111 @@
+#ifndef SESSIONJOURNAL_H
+#define SESSIONJOURNAL_H
+
+#include <QObject>
+#include <QFile>
+#include <QString>
+#include <QVector>
+
+class QTimer;
+
+// Журнал переходов таймера на случай аварийного завершения.
+// Пока сессия идёт, в бд ничего не пишется, поэтому после падения или kill
+// отработанное время терялось бы. Журнал дописывает в конец файла записи
+// фиксированного размера о старте, паузе, продолжении, завершении и
+// периодические контрольные точки. Запись — один write без транзакции, а fsync
+// выполняется пачками по таймеру; сразу на диск уходит только завершение.
+// При запуске журнал проигрывается: прерванную сессию можно продолжить, а
+// завершённую, но не дошедшую до sessions — записать повторно. Когда сессия
+// записана в бд, журнал сжимается до состояния текущей сессии.
+//
+//   Заголовок, 8 байт
+//     char[4]  magic       "APSJ"
+//     quint16  version     kVersion
+//     quint16  recordSize  kRecordSize
+//   Записи, по kRecordSize байт, little-endian
+//     quint8   type        RecordType
+//     quint8[3]            нули
+//     quint32  checksum    CRC-32 записи с нулевым полем checksum
+//     qint64   key, durationMs, elapsedMs, monotonicMs, wallMs
+//
+// Оборванная при падении запись не сходится по CRC и вместе с хвостом отбрасывается.
+class SessionJournal : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr char    kMagic[4] = {'A', 'P', 'S', 'J'};
+    static constexpr quint16 kVersion = 1;
+    static constexpr int     kHeaderSize = 8;
+    static constexpr int     kRecordSize = 48;
+    static constexpr int     kCheckpointIntervalMs = 15000;   // Сколько работы можно потерять при падении
+    static constexpr int     kSyncDelayMs = 2000;             // Окно, за которое записи копятся до одного fsync
+
+    enum RecordType : quint8 {
+        Start = 1,
+        Pause,
+        Resume,
+        Checkpoint,
+        Finish,
+        Reset
+    };
+
+    struct Record {
+        RecordType type = Checkpoint;
+        qint64 key = 0;           // Идентификатор сессии: момент старта по настенным часам, строго растёт
+        qint64 durationMs = 0;
+        qint64 elapsedMs = 0;     // Отработано к моменту записи
+        qint64 monotonicMs = 0;   // QElapsedTimer::msecsSinceReference, сравнимо в пределах одной загрузки ОС
+        qint64 wallMs = 0;        // Мс с начала эпохи
+    };
+
+    // Что журнал застал при открытии
+    struct Recovery {
+        bool            active = false;       // Есть прерванная сессия, session — её последнее состояние
+        Record          session;
+        bool            wasRunning = false;   // В момент падения шёл отсчёт, а не пауза
+        QVector<Record> finished;             // Завершены, но в sessions не записаны
+        qint64          discardedBytes = 0;   // Оборванный хвост
+    };
+
+    explicit SessionJournal(QObject *parent = nullptr);
+    ~SessionJournal() override;   // Досбрасывает накопленное на диск
+
+    // Проигрывает журнал и открывает его на дозапись. Завершённые сессии с
+    // ключом не больше committedKey уже есть в sessions и отбрасываются
+    bool open(const QString &path, qint64 committedKey = 0);
+    bool isOpen() const { return m_file.isOpen(); }
+    const Recovery &recovery() const { return m_recovery; }
+
+    qint64 start(qint64 durationMs);      // Новая сессия, возвращает её ключ
+    void   pause(qint64 elapsedMs);
+    void   resume(qint64 elapsedMs);
+    void   checkpoint(qint64 elapsedMs, bool force = false);   // Без force — не чаще раза в kCheckpointIntervalMs
+    qint64 finish(qint64 elapsedMs);      // Сразу на диск; возвращает ключ сессии или 0
+    void   reset();                       // Сессия отменена, восстанавливать нечего
+    void   commit(qint64 key);            // Сессия key записана в sessions — сжимает журнал
+    bool   sync();                        // fsync накопленного, не дожидаясь таймера
+
+    bool   hasActiveSession() const { return m_hasActive; }
+    qint64 activeKey() const { return m_hasActive ? m_active.key : 0; }
+    QString lastError() const { return m_lastError; }
+
+private:
+    void append(RecordType type, qint64 elapsedMs);
+    bool writeRecord(const Record &record);
+    bool compact();                       // Переписывает файл: незаписанные завершения и текущее состояние
+    void apply(const Record &record);     // Обновляет состояние в памяти так же, как при проигрывании
+
+    QFile           m_file;
+    QTimer         *m_syncTimer;
+    bool            m_dirty = false;      // Есть записи после последнего fsync
+    bool            m_hasActive = false;
+    Record          m_active;             // Последнее состояние текущей сессии
+    QVector<Record> m_finished;           // Завершены и ждут подтверждения записи в бд
+    qint64          m_lastKey = 0;
+    qint64          m_lastWriteMs = 0;    // Монотонное время последней записи, для контрольных точек
+    Recovery        m_recovery;
+    QString         m_lastError;
+};
+
+#endif // SESSIONJOURNAL_H
@@ -0,0 +1,48 @@
+#ifndef SESSIONTRANSFER_H
+#define SESSIONTRANSFER_H
+
+#include <QString>
+
+class QIODevice;
+class ProgressRepository;
+
+// Итоги одного импорта или экспорта
+struct TransferStats {
+    qint64 rows = 0;        // Записано или прочитано строк истории
+    qint64 skipped = 0;     // Пропущено некорректных строк при импорте
+    qint64 duplicates = 0;  // Пропущено сессий, которые уже есть в базе под тем же id
+    qint64 elapsedMs = 0;
+
+    double rowsPerSecond() const { return elapsedMs > 0 ? rows * 1000.0 / elapsedMs : double(rows); }
+};
+
+// Потоковый перенос истории sessions в файл и обратно.
+// Экспорт идёт forward-only запросом, импорт — порциями с многострочными
+// подготовленными INSERT в крупных транзакциях, так что память не зависит
+// от размера файла. Импорт сохраняет id из файла и пропускает уже
+// имеющиеся сессии, так что его можно безопасно повторить. При ошибке
+// откатывается только текущая транзакция, а stats->rows сообщает,
+// сколько строк уже зафиксировано.
+class SessionTransfer
+{
+public:
+    enum class Format {
+        Csv,      // id,start_time,duration_minutes с заголовком
+        NdJson    // По одному JSON-объекту на строку
+    };
+
+    static Format formatForPath(const QString &path);   // По расширению: .csv или .ndjson/.jsonl
+
+    explicit SessionTransfer(ProgressRepository *repository);
+
+    bool exportTo(QIODevice *out, Format format, TransferStats *stats = nullptr);
+    bool importFrom(QIODevice *in, Format format, TransferStats *stats = nullptr);
+
+    QString lastError() const { return m_lastError; }
+
+private:
+    ProgressRepository *m_repository;
+    QString             m_lastError;
+};
+
+#endif // SESSIONTRANSFER_H
@@ -0,0 +1,57 @@
+#ifndef SETTINGSSTORE_H
+#define SETTINGSSTORE_H
+
+#include <QObject>
+#include <QHash>
+#include <QList>
+#include <QPair>
+#include <QSet>
+#include <QString>
+
+class QTimer;
+class PersistenceWorker;
+
+// Настройки с отложенной записью.
+// Текущие значения живут в памяти, изменённые ключи помечаются «грязными»
+// и уходят в бд одной командой после паузы в изменениях, при завершении
+// сессии или при выходе. Так удержание стрелки спинбокса даёт одну
+// транзакцию вместо транзакции на каждый шаг.
+class SettingsStore : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int kQuietPeriodMs = 1000;   // Пауза без изменений перед записью
+
+    SettingsStore(PersistenceWorker *writer, const QString &profile, QObject *parent = nullptr);
+    ~SettingsStore() override;   // Дописывает несохранённые изменения
+
+    // Дописывает изменения в базу прежнего профиля и начинает с пустых значений нового
+    void    setProfile(const QString &profile);
+    QString profile() const { return m_profile; }
+
+    void    load(const QString &key, const QString &value);   // Значение из бд, без пометки на запись
+    QString value(const QString &key, const QString &defaultValue = QString()) const;
+    void    setValue(const QString &key, const QString &value);
+    // Одно сохранение из нескольких ключей: раньше каждое такое было отдельной транзакцией
+    void    setValues(const QList<QPair<QString, QString>> &values);
+
+    bool   hasPendingChanges() const { return !m_dirty.isEmpty(); }
+    qint64 saveRequests() const { return m_saveRequests; }   // Вызовов setValue и setValues
+    qint64 transactions() const { return m_transactions; }   // Команд записи, отправленных в бд
+    qint64 writesAvoided() const { return m_saveRequests - m_transactions; }   // Сохранений, не ставших транзакцией
+
+public slots:
+    void flush();   // Немедленно отправляет грязные ключи одной командой
+
+private:
+    PersistenceWorker      *m_writer;   // Может быть nullptr, если бд недоступна
+    QString                 m_profile;
+    QTimer                 *m_flushTimer;
+    QHash<QString, QString> m_values;
+    QSet<QString>           m_dirty;
+    qint64                  m_saveRequests = 0;
+    qint64                  m_transactions = 0;
+};
+
+#endif // SETTINGSSTORE_H
@@ -0,0 +1,57 @@
+#ifndef STARTUPTRACE_H
+#define STARTUPTRACE_H
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+#include "trace.h"
+
+// Журнал этапов запуска: для каждого этапа запоминаются начало и конец
+// от момента создания журнала и поток, в котором он выполнялся.
+// Этапы могут идти параллельно, поэтому запись защищена мьютексом.
+// Если включена трассировка, каждый этап попадает и в неё как Trace::Span.
+class StartupTrace
+{
+public:
+    // Отмечает этап от создания до разрушения объекта
+    class Scope
+    {
+    public:
+        Scope(StartupTrace &trace, const char *stage);
+        ~Scope();
+
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+
+    private:
+        StartupTrace &m_trace;
+        const char   *m_stage;
+        qint64        m_beginNs;
+        Trace::Span   m_span;
+    };
+
+    StartupTrace();
+
+    qint64 elapsedNs() const { return m_clock.nsecsElapsed(); }
+    void   record(const char *stage, qint64 beginNs, qint64 endNs);
+    void   mark(const char *stage);       // Мгновенное событие, например «окно показано»
+
+    QString report() const;               // Таблица этапов в порядке начала
+
+private:
+    struct Entry {
+        QByteArray stage;
+        qint64     beginNs;
+        qint64     endNs;
+        bool       mainThread;
+    };
+
+    QElapsedTimer   m_clock;
+    Qt::HANDLE      m_mainThread;
+    mutable QMutex  m_mutex;              // Защищает m_entries
+    QVector<Entry>  m_entries;
+};
+
+#endif // STARTUPTRACE_H
@@ -0,0 +1,32 @@
+#ifndef STATSDIALOG_H
+#define STATSDIALOG_H
+
+#include <QDialog>
+
+class QLabel;
+class QComboBox;
+class QTableWidget;
+class ProgressRepository;
+
+// Диалог статистики: итоги за сегодня, неделю, месяц и всё время,
+// серии дней подряд и таблица по дням, неделям или месяцам.
+// Все запросы идут к свёрткам, поэтому открытие не зависит от длины истории.
+class StatsDialog : public QDialog {
+    Q_OBJECT
+public:
+    explicit StatsDialog(ProgressRepository *repository, QWidget *parent = nullptr);
+
+private slots:
+    void updateTable();   // Перечитывает таблицу под выбранный период
+
+private:
+    void setupUI();
+    void loadSummary();
+
+    ProgressRepository *m_repository;
+    QLabel             *m_summaryLabel;
+    QComboBox          *m_periodComboBox;
+    QTableWidget       *m_table;
+};
+
+#endif // STATSDIALOG_H
@@ -0,0 +1,66 @@
+#ifndef THEME_H
+#define THEME_H
+
+#include <QColor>
+#include <QFont>
+#include <QPalette>
+#include <QString>
+
+// Неизменяемое описание темы оформления: палитра приложения и параметры
+// отрисовки отдельных элементов. Обе темы собираются один раз при первом
+// обращении, а переключение только меняет палитры — без таблиц стилей,
+// поэтому Qt не разбирает CSS и не выполняет повторный polish всех виджетов.
+class Theme
+{
+public:
+    static const Theme &light();
+    static const Theme &dark();
+    static const Theme &byName(const QString &name);   // Неизвестное имя — светлая тема
+    static const Theme &current();                     // Последняя применённая через apply
+
+    // Ставит палитру приложения и подсказок. Повторное применение той же темы ничего не делает
+    static void apply(const Theme &theme);
+
+    QString name() const { return m_name; }
+    bool    isDark() const { return m_dark; }
+
+    const QPalette &palette() const { return m_palette; }
+
+    // Палитры с одной переопределённой ролью: остальные роли виджет наследует от родителя
+    const QPalette &timePalette() const { return m_timePalette; }
+    const QPalette &counterPalette() const { return m_counterPalette; }
+    const QPalette &quotePalette() const { return m_quotePalette; }
+    const QPalette &infoPalette() const { return m_infoPalette; }    // Плашки-сводки в диалогах
+
+    // Шрифты одинаковы в обеих темах и ставятся один раз при построении интерфейса
+    static QFont timeFont();
+    static QFont counterFont();
+    static QFont quoteFont();
+
+    // Цвета выделения новой цитаты
+    QColor revealText() const { return m_revealText; }
+    QColor revealBackground() const { return m_revealBackground; }
+    QColor highlightText() const { return m_highlightText; }
+    QColor highlightBackground() const { return m_highlightBackground; }
+
+private:
+    Theme() = default;
+    static Theme makeLight();
+    static Theme makeDark();
+    void buildRolePalettes(const QColor &time, const QColor &counter, const QColor &quote,
+                           const QColor &infoText, const QColor &infoBackground);
+
+    QString  m_name;
+    bool     m_dark = false;
+    QPalette m_palette;
+    QPalette m_timePalette;
+    QPalette m_counterPalette;
+    QPalette m_quotePalette;
+    QPalette m_infoPalette;
+    QColor   m_revealText;
+    QColor   m_revealBackground;
+    QColor   m_highlightText;
+    QColor   m_highlightBackground;
+};
+
+#endif // THEME_H
@@ -0,0 +1,66 @@
+#ifndef TIMERDAEMON_H
+#define TIMERDAEMON_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QSet>
+#include <QString>
+
+class QLocalServer;
+class QLocalSocket;
+class TimerEngine;
+class PersistenceWorker;
+
+// Таймер без окна, управляемый по локальному сокету (QLocalServer).
+// Протокол строковый, одна команда или событие на строку:
+//   start [минуты]  -> ok running <осталось_мс>
+//   pause           -> ok paused <осталось_мс>
+//   reset [минуты]  -> ok idle <осталось_мс>
+//   status          -> ok <idle|running|paused> <осталось_мс> <длительность_мс>
+//   subscribe       -> ok subscribed, далее события «tick <осталось_с>» и «finished»
+//   unsubscribe     -> ok unsubscribed
+// Ошибки приходят строкой «err <причина>». Ответ пишется прямо из обработчика
+// readyRead без промежуточных очередей, так что задержка — доли миллисекунды.
+// Пока нет подписчиков, события tick никому не нужны, и движок просыпается
+// только в момент дедлайна.
+class TimerDaemon : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr const char *kDefaultServerName = "antiprocrastinator";
+
+    // writer может быть nullptr: тогда завершённые сессии не сохраняются.
+    // profile — профиль, в чью базу пишутся сессии; цитат они не открывают
+    TimerDaemon(int defaultMinutes, PersistenceWorker *writer, const QString &profile,
+                QObject *parent = nullptr);
+
+    // Не запускается, если по этому имени уже отвечает другой таймер;
+    // сокет, оставшийся от упавшего процесса, удаляется. Доступ — только у владельца
+    bool    listen(const QString &serverName);
+    QString errorString() const;
+
+private slots:
+    void onNewConnection();
+    void onReadyRead();
+    void onDisconnected();
+    void onTicked(int remainingSeconds);
+    void onFinished();
+
+private:
+    QByteArray handleCommand(QLocalSocket *client, const QByteArray &line);
+    QByteArray stateLine() const;     // «<состояние> <осталось_мс>»
+    void       setMinutes(int minutes);
+    void       broadcast(const QByteArray &event);
+    void       updateWakeInterval();   // Посекундно, только если есть подписчики
+
+    QLocalServer        *m_server;
+    TimerEngine         *m_engine;
+    PersistenceWorker   *m_writer;
+    QString              m_profile;
+    int                  m_minutes;
+    QString              m_listenError;   // Причина отказа listen, не связанная с QLocalServer
+    QSet<QLocalSocket *> m_subscribers;
+};
+
+#endif // TIMERDAEMON_H
@@ -0,0 +1,62 @@
+#ifndef TIMERENGINE_H
+#define TIMERENGINE_H
+
+#include <QObject>
+#include <QElapsedTimer>
+
+class QTimer;
+
+// Движок обратного отсчёта на монотонном дедлайне.
+// Оставшееся время не уменьшается «по тику», а каждый раз вычисляется от
+// монотонных часов, поэтому опоздавшие или склеенные срабатывания QTimer
+// не накапливают дрейф.
+// Пока отсчёт никто не видит, посекундные пробуждения не нужны: setWakeInterval
+// переводит движок на редкие пробуждения или одно — в момент дедлайна.
+class TimerEngine : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit TimerEngine(QObject *parent = nullptr);
+
+    void setDuration(qint64 durationMs);  // Останавливает отсчёт и заводит его на новую длительность
+    void start();                         // Запускает или продолжает отсчёт после паузы
+    void pause();                         // Останавливает отсчёт, запоминая уже прошедшее время
+    void reset();                         // Возвращает отсчёт к полной длительности
+    void restore(qint64 durationMs, qint64 elapsedMs);   // Ставит на паузу с уже отработанным временем
+
+    static constexpr qint64 kTickMs = 1000;
+    // kTickMs — на каждой границе секунды (по умолчанию), больше — не реже чем
+    // раз в intervalMs, 0 — только в момент дедлайна. Идущий отсчёт перезаводится сразу
+    void   setWakeInterval(qint64 intervalMs);
+    qint64 wakeInterval() const { return m_wakeIntervalMs; }
+    quint64 wakeups() const { return m_wakeups; }   // Срабатывания таймера за всё время
+    qint64  activeMs() const;                       // Сколько всего шёл отсчёт, по всем сессиям
+
+    bool   isRunning() const { return m_running; }
+    qint64 durationMs() const { return m_durationMs; }
+    qint64 elapsedMs() const;
+    qint64 remainingMs() const;
+    int    remainingSeconds() const;      // Округляется вверх: 24:59.4 отображается как 25:00
+
+signals:
+    void ticked(int remainingSeconds);    // Срабатывает при каждом пробуждении, обычно на границе секунды
+    void finished();
+
+private slots:
+    void onTimeout();
+
+private:
+    void arm();                           // Заводит таймер до ближайшего пробуждения по m_wakeIntervalMs
+
+    QTimer        *m_timer;
+    QElapsedTimer  m_clock;               // Монотонные часы текущего отрезка работы
+    qint64         m_durationMs = 0;
+    qint64         m_bankedMs = 0;        // Время, отработанное до последней паузы
+    bool           m_running = false;
+    qint64         m_wakeIntervalMs = kTickMs;
+    quint64        m_wakeups = 0;
+    qint64         m_activeMs = 0;        // Отсчёт по всем сессиям до текущего отрезка работы
+};
+
+#endif // TIMERENGINE_H
@@ -0,0 +1,91 @@
+#ifndef TIMINGWHEEL_H
+#define TIMINGWHEEL_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QVector>
+
+class QTimer;
+
+// Иерархическое колесо таймеров для хоста, который ведёт сотни и тысячи
+// помодоро одновременно (например, общая «комната команды»).
+// Четыре уровня по 64 слота: таймер кладётся в слот по битам своего
+// дедлайна, а при обороте нижнего уровня записи верхнего слота спускаются
+// ниже. Запуск, пауза, продолжение и отмена — O(1) (двусвязные списки
+// в общем пуле узлов), а процесс просыпается один раз за тик независимо
+// от числа таймеров.
+class TimingWheel : public QObject
+{
+    Q_OBJECT
+
+public:
+    using Handle = quint64;   // Индекс узла и поколение; устаревший Handle безопасно игнорируется
+
+    static constexpr Handle kInvalidHandle = 0;
+
+    explicit TimingWheel(int tickMs = 1000, QObject *parent = nullptr);
+
+    Handle start(qint64 durationMs);
+    bool   pause(Handle handle);
+    bool   resume(Handle handle);
+    bool   cancel(Handle handle);
+
+    bool   isActive(Handle handle) const;       // Запущен или на паузе
+    bool   isPaused(Handle handle) const;
+    qint64 remainingMs(Handle handle) const;    // С точностью до тика
+    int    activeCount() const { return m_activeCount; }
+    int    tickMs() const { return m_tickMs; }
+
+    // Продвигает колесо на заданное число тиков. Обычно вызывается собственным
+    // QTimer, но хост или бенчмарк могут крутить колесо вручную
+    void advance(int ticks = 1);
+
+signals:
+    void expired(quint64 handle);   // Handle сработавшего таймера, он уже освобождён
+
+private slots:
+    void onTimeout();
+
+private:
+    static constexpr int kLevelBits = 6;
+    static constexpr int kSlotsPerLevel = 1 << kLevelBits;
+    static constexpr int kLevels = 4;
+    static constexpr qint64 kMaxDelta = (qint64(1) << (kLevelBits * kLevels)) - 1;
+
+    enum class State : quint8 { Free, Scheduled, Paused };
+
+    struct Node {
+        qint64  expiresTick = 0;   // Абсолютный тик срабатывания (Scheduled)
+        qint64  remainingTicks = 0;// Остаток (Paused)
+        int     prev = -1;
+        int     next = -1;         // В свободном списке — следующий свободный узел
+        int     slot = -1;         // Глобальный номер слота: уровень * 64 + индекс
+        quint32 generation = 1;
+        State   state = State::Free;
+    };
+
+    int    nodeIndex(Handle handle) const;      // -1, если Handle устарел
+    Handle makeHandle(int index) const;
+    int    allocate();
+    void   release(int index);
+    void   schedule(int index);                 // Кладёт узел в слот по его дедлайну
+    void   unlink(int index);
+    void   cascade(int level);                  // Спускает записи текущего слота уровня ниже
+    void   tick();
+    void   updateDriver();                      // Держит QTimer запущенным, только пока есть таймеры
+
+    int            m_tickMs;
+    qint64         m_now = 0;                   // Текущий тик колеса
+    QVector<Node>  m_nodes;
+    int            m_freeHead = -1;
+    int            m_heads[kLevels * kSlotsPerLevel];
+    int            m_activeCount = 0;               // Запущенные и на паузе
+    int            m_scheduledCount = 0;            // Только запущенные: им нужен тик
+    QVector<Handle> m_expired;                  // Буфер сработавших за тик
+
+    QTimer        *m_timer;
+    QElapsedTimer  m_clock;                     // Чтобы не накапливать дрейф при опоздавших тиках
+    qint64         m_clockBaseTick = 0;         // m_now в момент запуска m_clock
+};
+
+#endif // TIMINGWHEEL_H
@@ -0,0 +1,74 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <QString>
+#include <QtGlobal>
+#include <atomic>
+
+// Трассировка горячих путей в формате Chrome trace-event (chrome://tracing, Perfetto).
+// Каждый поток пишет события в собственный кольцевой буфер без блокировок:
+// запись — несколько атомарных сохранений в память своего потока, а старые
+// события при переполнении затираются. При выключенной трассировке Span и
+// counter сводятся к одному чтению атомарного флага.
+// Включается ключом TRACE_PATH в .env; файл пишется в Trace::finish при выходе.
+// Имена событий должны жить до конца программы (строковые литералы):
+// буфер хранит только указатель.
+class Trace
+{
+public:
+    static constexpr int kDefaultEventsPerThread = 65536;
+
+    static bool isEnabled() { return s_enabled.load(std::memory_order_relaxed); }
+
+    // Включает запись; outputPath — куда finish() выгрузит JSON
+    static void start(const QString &outputPath, int eventsPerThread = kDefaultEventsPerThread);
+    // Выключает запись и выгружает буферы всех потоков. Вызывается из главного потока при выходе
+    static bool finish();
+
+    // Значение во времени, например длина очереди
+    static void counter(const char *name, qint64 value)
+    {
+        if (isEnabled()) record(Counter, name, nowNs(), value);
+    }
+    // Мгновенное событие
+    static void instant(const char *name)
+    {
+        if (isEnabled()) record(Instant, name, nowNs(), 0);
+    }
+    static qint64 nowNs();   // От вызова start()
+
+    // Интервал от создания до разрушения объекта
+    class Span
+    {
+    public:
+        explicit Span(const char *name)
+            : m_name(isEnabled() ? name : nullptr)
+            , m_beginNs(m_name ? nowNs() : 0)
+        {
+        }
+        ~Span()
+        {
+            if (m_name) record(Complete, m_name, m_beginNs, nowNs() - m_beginNs);
+        }
+
+        Span(const Span &) = delete;
+        Span &operator=(const Span &) = delete;
+
+    private:
+        const char *m_name;   // nullptr, если трассировка была выключена при входе
+        qint64      m_beginNs;
+    };
+
+private:
+    enum Phase : char {
+        Complete = 'X',   // value — длительность в нс
+        Counter = 'C',    // value — значение счётчика
+        Instant = 'i'
+    };
+
+    static void record(Phase phase, const char *name, qint64 timestampNs, qint64 value);
+
+    static inline std::atomic<bool> s_enabled{false};
+};
+
+#endif // TRACE_H
@@ -1,30 +1,186 @@
 #include <QApplication>
+#include <QCommandLineParser>
+#include <QFile>
 #include <QStyleFactory>
-#include <QPalette>
-#include <QColor>
+#include <QDebug>
 #include "headers/antiprocrastinator.h"
+#include "headers/envconfig.h"
+#include "headers/theme.h"
+#include "headers/progressrepository.h"
+#include "headers/connectionpool.h"
+#include "headers/sessiontransfer.h"
+#include "headers/persistenceworker.h"
+#include "headers/timerdaemon.h"
+#include "headers/trace.h"
+
+namespace {
+
+// Консольные команды распознаются до создания QApplication, чтобы не требовать дисплей
+bool isTransferCommand(int argc, char *argv[])
+{
+    for (int i = 1; i < argc; ++i) {
+        const QByteArray arg(argv[i]);
+        if (arg.startsWith("--export") || arg.startsWith("--import")) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool isHeadlessCommand(int argc, char *argv[])
+{
+    for (int i = 1; i < argc; ++i) {
+        if (QByteArray(argv[i]) == "--headless") {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Профиль из --profile или из .env
+QString selectedProfile(const QCommandLineParser &parser, const QCommandLineOption &option, const EnvConfig &config)
+{
+    return parser.isSet(option) ? parser.value(option) : config.profile;
+}
+
+// antiprocrastinator --headless [--socket name] [--profile name]: таймер без окна, управляемый по локальному сокету
+int runHeadless(QCoreApplication &app)
+{
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Таймер без окна с управлением через локальный сокет");
+    parser.addHelpOption();
+    const QCommandLineOption headlessOption("headless", "Запустить таймер без графического интерфейса.");
+    const QCommandLineOption socketOption("socket", "Имя локального сокета (по умолчанию antiprocrastinator).",
+                                          "name", TimerDaemon::kDefaultServerName);
+    const QCommandLineOption profileOption("profile", "Профиль, в базу которого пишутся сессии (по умолчанию из .env).",
+                                           "name");
+    parser.addOption(headlessOption);
+    parser.addOption(socketOption);
+    parser.addOption(profileOption);
+    parser.process(app);
+
+    const EnvConfig config = loadEnvConfig();
+    if (!config.tracePath.isEmpty()) {
+        Trace::start(config.tracePath, config.traceBufferEvents);
+    }
+    const QString profile = selectedProfile(parser, profileOption, config);
+    ConnectionPool pool(config.dbPath);
+    int minutes = config.defaultDuration;
+    {
+        // Схему и сохранённую длительность читаем один раз до запуска потока записи
+        QString error;
+        ProgressRepository *repository = pool.acquire(profile, nullptr, &error);
+        if (!repository) {
+            qCritical() << "Не удалось открыть БД:" << error;
+            return 1;
+        }
+        repository->seedSettings(config.defaultTheme, config.defaultDuration);
+        minutes = repository->getSetting("duration", QString::number(minutes)).toInt();
+    }
+
+    int status = 0;
+    {
+        PersistenceWorker writer(&pool, profile);
+        QObject::connect(&writer, &PersistenceWorker::writeFailed, [](int, const QString &error) {
+            qWarning() << "Ошибка записи прогресса:" << error;
+        });
+
+        TimerDaemon daemon(minutes, &writer, profile);
+        if (!daemon.listen(parser.value(socketOption))) {
+            qCritical() << "Не удалось открыть сокет:" << daemon.errorString();
+            return 1;
+        }
+        qInfo().noquote() << "Ожидание команд на сокете" << parser.value(socketOption);
+        status = app.exec();
+    }
+
+    // Поток записи уже дописал очередь, его транзакции попадут в трассировку
+    Trace::finish();
+    return status;
+}
+
+// antiprocrastinator --export sessions.csv | --import sessions.ndjson [--profile name]
+int runTransferCommand(QCoreApplication &app)
+{
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Перенос истории сессий в CSV или NDJSON и обратно");
+    parser.addHelpOption();
+    const QCommandLineOption exportOption("export", "Выгрузить историю сессий в <file> (.csv или .ndjson).", "file");
+    const QCommandLineOption importOption("import", "Загрузить историю сессий из <file> (.csv или .ndjson).", "file");
+    const QCommandLineOption profileOption("profile", "Профиль, чья история переносится (по умолчанию из .env).",
+                                           "name");
+    parser.addOption(exportOption);
+    parser.addOption(importOption);
+    parser.addOption(profileOption);
+    parser.process(app);
+
+    const bool exporting = parser.isSet(exportOption);
+    if (exporting == parser.isSet(importOption)) {
+        qCritical() << "Нужно указать ровно одну из опций --export или --import";
+        return 2;
+    }
+    const QString path = parser.value(exporting ? exportOption : importOption);
+
+    const EnvConfig config = loadEnvConfig();
+    // Пул открывает шард профиля сразу в режиме WAL и создаёт схему
+    ConnectionPool pool(config.dbPath);
+    QString error;
+    ProgressRepository *repository = pool.acquire(selectedProfile(parser, profileOption, config), nullptr, &error);
+    if (!repository) {
+        qCritical() << "Не удалось открыть БД:" << error;
+        return 1;
+    }
+
+    QFile file(path);
+    if (!file.open(exporting ? QIODevice::WriteOnly | QIODevice::Truncate : QIODevice::ReadOnly)) {
+        qCritical() << "Не удалось открыть файл:" << path << file.errorString();
+        return 1;
+    }
+
+    SessionTransfer transfer(repository);
+    const SessionTransfer::Format format = SessionTransfer::formatForPath(path);
+    TransferStats stats;
+    const bool ok = exporting ? transfer.exportTo(&file, format, &stats)
+                              : transfer.importFrom(&file, format, &stats);
+    if (!ok) {
+        qCritical() << "Ошибка переноса истории:" << transfer.lastError();
+        if (!exporting) {
+            qInfo().noquote() << QString("Зафиксировано строк до ошибки: %1").arg(stats.rows);
+        }
+        return 1;
+    }
+
+    qInfo().noquote() << QString("%1 строк: %2 за %3 мс (%4 строк/с), пропущено: %5, уже были в базе: %6")
+                             .arg(exporting ? "Выгружено" : "Загружено")
+                             .arg(stats.rows)
+                             .arg(stats.elapsedMs)
+                             .arg(qRound64(stats.rowsPerSecond()))
+                             .arg(stats.skipped)
+                             .arg(stats.duplicates);
+    return 0;
+}
+
+} // namespace
 
 int main(int argc, char *argv[])
 {
+    if (isTransferCommand(argc, argv)) {
+        QCoreApplication app(argc, argv);
+        return runTransferCommand(app);
+    }
+    if (isHeadlessCommand(argc, argv)) {
+        QCoreApplication app(argc, argv);
+        return runHeadless(app);
+    }
+
     QApplication app(argc, argv);
 
     if (QStyleFactory::keys().contains("Fusion")) {
         app.setStyle(QStyleFactory::create("Fusion"));
     }
 
-    QPalette palette;
-    palette.setColor(QPalette::Window, QColor(245, 247, 250));
-    palette.setColor(QPalette::WindowText, QColor(44, 62, 80));
-    palette.setColor(QPalette::Base, Qt::white);
-    palette.setColor(QPalette::AlternateBase, QColor(240, 240, 240));
-    palette.setColor(QPalette::ToolTipBase, Qt::white);
-    palette.setColor(QPalette::ToolTipText, Qt::black);
-    palette.setColor(QPalette::Button, QColor(230, 230, 230));
-    palette.setColor(QPalette::ButtonText, QColor(44, 62, 80));
-    palette.setColor(QPalette::BrightText, Qt::red);
-    palette.setColor(QPalette::Highlight, QColor(52, 152, 219));
-    palette.setColor(QPalette::HighlightedText, Qt::white);
-    app.setPalette(palette);
+    // До загрузки настроек показываем светлую тему, окно затем применит сохранённую
+    Theme::apply(Theme::light());
 
     Antiprocrastinator window;
     window.show();
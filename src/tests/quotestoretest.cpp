@@ -0,0 +1,111 @@
+// Проверки QuoteStore: открытые цитаты переживают перезапуск, в том числе
+// когда в файле есть повторяющиеся строки, а пакет с записью за пределами
+// блока текстов отклоняется, а идентификаторы в пакете совпадают с текстовыми
+// даже для строк с битым UTF-8.
+//   ctest --test-dir build
+
+#include <QtTest>
+#include <QFile>
+#include <QTemporaryDir>
+#include "../headers/quotepack.h"
+#include "../headers/quotepackwriter.h"
+#include "../headers/quotestore.h"
+
+class QuoteStoreTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void duplicateLinesSurviveRestart();
+    void packEntryOutOfBoundsRejected();
+    void packKeepsIdsOfInvalidUtf8();
+};
+
+void QuoteStoreTest::duplicateLinesSurviveRestart()
+{
+    const QStringList quotes = {"Первая", "Вторая", "Первая", "Третья"};
+
+    // Сессии открывают цитаты, а в бд уходят их идентификаторы
+    QuoteStore store;
+    store.setQuotes(quotes);
+    QVector<quint64> savedIds;
+    int index = -1;
+    while ((index = store.unlockNext()) >= 0) {
+        savedIds << store.id(index);
+    }
+    // Повтор «Первой» — та же цитата, отдельно он не открывается
+    QCOMPARE(savedIds.size(), 3);
+    QVERIFY(!store.isUnlocked(2));
+
+    // После перезапуска открыто ровно то же, и следующая сессия ничего не открывает повторно
+    QuoteStore restored;
+    restored.setQuotes(quotes);
+    QCOMPARE(restored.setUnlockedIds(savedIds), savedIds.size());
+    for (int i = 0; i < quotes.size(); ++i) {
+        QCOMPARE(restored.isUnlocked(i), store.isUnlocked(i));
+    }
+    QCOMPARE(restored.unlockNext(), -1);
+}
+
+void QuoteStoreTest::packEntryOutOfBoundsRejected()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = dir.filePath("quotes.qpack");
+
+    QuoteStore source;
+    source.setQuotes({"Первая", "Вторая"});
+    QVERIFY(QuotePack::write(source, path));
+    QuoteStore store;
+    QVERIFY(store.loadPack(path));
+
+    // Длина второй записи указывает за блок текстов, а контрольная сумма
+    // пересчитана, как в собранном с ошибкой пакете
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    QByteArray data = file.readAll();
+    uchar *bytes = reinterpret_cast<uchar *>(data.data());
+    using namespace QuotePack;
+    const quint32 tableOffset = qFromLittleEndian<quint32>(bytes + kTableOffsetField);
+    const quint32 blobOffset = qFromLittleEndian<quint32>(bytes + kBlobOffsetField);
+    const quint32 blobSize = qFromLittleEndian<quint32>(bytes + kBlobSizeField);
+    qToLittleEndian<quint32>(blobSize, bytes + tableOffset + kEntrySize + kEntryLengthField);
+    const quint32 crc = crc32(bytes + tableOffset, qsizetype(blobOffset) + blobSize - tableOffset);
+    qToLittleEndian<quint32>(crc, bytes + kChecksumField);
+    QVERIFY(file.seek(0));
+    QCOMPARE(file.write(data), data.size());
+    file.close();
+
+    QVERIFY(!store.loadPack(path));
+    QCOMPARE(store.size(), 0);
+}
+
+void QuoteStoreTest::packKeepsIdsOfInvalidUtf8()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString textPath = dir.filePath("quotes.txt");
+    const QString packPath = dir.filePath("quotes.qpack");
+
+    // Вторая строка в Latin-1: для QString это U+FFFD, для id — исходные байты
+    QFile file(textPath);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write("Первая\nCaf\xe9 cr\xe8me\nТретья\n");
+    file.close();
+
+    QuoteStore text;
+    QVERIFY(text.loadFile(textPath));
+    QVERIFY(QuotePack::write(text, packPath));
+    QuoteStore pack;
+    QVERIFY(pack.loadPack(packPath));
+
+    QCOMPARE(pack.size(), text.size());
+    for (int i = 0; i < text.size(); ++i) {
+        QCOMPARE(pack.id(i), text.id(i));
+        QCOMPARE(pack.indexOf(text.id(i)), i);
+        QVERIFY(pack.bytes(i) == text.bytes(i));
+    }
+}
+
+QTEST_GUILESS_MAIN(QuoteStoreTest)
+#include "quotestoretest.moc"
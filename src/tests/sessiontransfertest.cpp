@@ -0,0 +1,79 @@
+// Проверки импорта истории: время сессии сохраняется в UTC, как его
+// пишет CURRENT_TIMESTAMP, а свёртки переводят его в местные дни.
+//   ctest --test-dir build
+
+#include <QtTest>
+#include <QBuffer>
+#include <QSqlQuery>
+#include <QTemporaryDir>
+#include "../headers/progressrepository.h"
+#include "../headers/sessiontransfer.h"
+
+class SessionTransferTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void startTimeInUtc_data();
+    void startTimeInUtc();
+
+private:
+    QTemporaryDir m_dir;
+};
+
+void SessionTransferTest::initTestCase()
+{
+    // Местный пояс не совпадает с UTC: иначе время без пояса, прочитанное
+    // как местное, не отличить от прочитанного как UTC
+    qputenv("TZ", "TST-05");
+    QVERIFY(m_dir.isValid());
+}
+
+void SessionTransferTest::startTimeInUtc_data()
+{
+    QTest::addColumn<QByteArray>("line");
+    QTest::addColumn<QString>("stored");   // Пусто — строка пропущена
+
+    QTest::newRow("смещение") << QByteArray("2024-01-01T10:00:00+03:00,25") << "2024-01-01 07:00:00";
+    QTest::newRow("смещение через полночь") << QByteArray("2024-01-01T23:30:00-02:00,25") << "2024-01-02 01:30:00";
+    QTest::newRow("Z") << QByteArray("2024-01-01T10:00:00Z,25") << "2024-01-01 10:00:00";
+    QTest::newRow("ISO без пояса") << QByteArray("2024-01-01T10:00:00,25") << "2024-01-01 10:00:00";
+    QTest::newRow("формат экспорта") << QByteArray("2024-01-01 10:00:00,25") << "2024-01-01 10:00:00";
+    QTest::newRow("только дата") << QByteArray("2024-01-01,25") << QString();
+    QTest::newRow("мусор") << QByteArray("вчера вечером,25") << QString();
+}
+
+void SessionTransferTest::startTimeInUtc()
+{
+    QFETCH(QByteArray, line);
+    QFETCH(QString, stored);
+
+    ProgressRepository repository(QString("transfer_test_%1").arg(QTest::currentDataTag()));
+    QVERIFY(repository.open(m_dir.filePath(QString("%1.db").arg(QTest::currentDataTag()))));
+    QVERIFY(repository.initSchema());
+
+    // Первая строка CSV считается заголовком, поэтому проверяемая идёт второй
+    QByteArray data = "start_time,duration_minutes\n" + line + '\n';
+    QBuffer in(&data);
+    QVERIFY(in.open(QIODevice::ReadOnly));
+
+    SessionTransfer transfer(&repository);
+    TransferStats stats;
+    QVERIFY2(transfer.importFrom(&in, SessionTransfer::Format::Csv, &stats), qPrintable(transfer.lastError()));
+    QCOMPARE(stats.rows, qint64(stored.isEmpty() ? 0 : 1));
+    QCOMPARE(stats.skipped, qint64(stored.isEmpty() ? 1 : 0));
+
+    QSqlQuery query(repository.database());
+    QVERIFY(query.exec("SELECT start_time FROM sessions"));
+    if (stored.isEmpty()) {
+        QVERIFY(!query.next());
+    } else {
+        QVERIFY(query.next());
+        QCOMPARE(query.value(0).toString(), stored);
+    }
+    query.finish();
+}
+
+QTEST_GUILESS_MAIN(SessionTransferTest)
+#include "sessiontransfertest.moc"
@@ -0,0 +1,91 @@
+// Проверки TimerEngine: показанные секунды совпадают с настенными часами,
+// не повторяются и не пропадают, даже когда цикл событий надолго занят
+// между тиками, а сессия кончается вовремя.
+//   ctest --test-dir build
+
+#include <QtTest>
+#include <QElapsedTimer>
+#include <QThread>
+#include "../headers/timerengine.h"
+
+namespace {
+
+constexpr qint64 kDurationMs = 6000;
+constexpr qint64 kClockSlackMs = 20;   // Разница запуска часов теста и движка и задержка вызова обработчика
+
+} // namespace
+
+class TimerEngineTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void driftUnderLoad_data();
+    void driftUnderLoad();
+};
+
+void TimerEngineTest::driftUnderLoad_data()
+{
+    QTest::addColumn<int>("blockMs");
+    QTest::newRow("300 мс") << 300;
+    QTest::newRow("700 мс") << 700;
+    QTest::newRow("1500 мс") << 1500;   // Дольше тика: срабатывания склеиваются
+}
+
+void TimerEngineTest::driftUnderLoad()
+{
+    QFETCH(int, blockMs);
+
+    TimerEngine engine;
+    engine.setDuration(kDurationMs);
+    QElapsedTimer wall;
+    QList<int> shown;            // Секунды, которые увидел бы пользователь
+    QStringList wrongSeconds;
+    qint64 handlerFreeAt = 0;    // Когда обработчик последнего тика отпустил цикл событий
+    qint64 finishedAt = -1;
+
+    connect(&engine, &TimerEngine::ticked, this, [&](int remainingSeconds) {
+        // Показанная секунда должна быть верной для настенных часов: оставшееся
+        // время лежит в ((n - 1) * 1000, n * 1000]. Часы теста запущены чуть раньше
+        // движка, поэтому по ним остаётся чуть меньше — на это и запас kClockSlackMs
+        const qint64 wallRemainingMs = qMax<qint64>(0, kDurationMs - wall.elapsed());
+        if (wallRemainingMs > qint64(remainingSeconds) * 1000
+            || wallRemainingMs <= qint64(remainingSeconds - 1) * 1000 - kClockSlackMs) {
+            wrongSeconds << QString("%1 с при остатке %2 мс").arg(remainingSeconds).arg(wallRemainingMs);
+        }
+        shown << remainingSeconds;
+        // Обработчик занимает цикл событий, как тяжёлая перерисовка или диалог
+        if (remainingSeconds > 0) QThread::msleep(blockMs);
+        handlerFreeAt = wall.elapsed();
+    });
+    connect(&engine, &TimerEngine::finished, this, [&]() { finishedAt = wall.elapsed(); });
+
+    wall.start();
+    engine.start();
+    QTRY_VERIFY_WITH_TIMEOUT(finishedAt >= 0, int(kDurationMs) + 5000);
+
+    QVERIFY(shown.size() > 1);
+    QVERIFY2(wrongSeconds.isEmpty(), qPrintable(wrongSeconds.join("; ")));
+    QCOMPARE(shown.constLast(), 0);
+    for (int i = 1; i < shown.size(); ++i) {
+        const int step = shown.at(i - 1) - shown.at(i);
+        // Опоздавший тик не повторяет уже показанную секунду
+        QVERIFY2(step > 0, qPrintable(QString("секунда %1 показана дважды").arg(shown.at(i))));
+        // Пока обработчик короче тика, ни одна секунда не пропадает. Более долгая
+        // блокировка склеивает тики, и пропущены ровно те секунды, что прошли за
+        // время блокировки: это уже проверено по настенным часам выше
+        if (blockMs < TimerEngine::kTickMs) {
+            QVERIFY2(step == 1, qPrintable(QString("пропущена секунда после %1").arg(shown.at(i - 1))));
+        }
+    }
+
+    // Сессия кончается не раньше дедлайна. Позже — только пока обработчик держит
+    // цикл событий; после этого опоздание меньше тика
+    QVERIFY(finishedAt >= kDurationMs);
+    const qint64 lateMs = finishedAt - qMax(kDurationMs, handlerFreeAt);
+    QVERIFY2(lateMs < TimerEngine::kTickMs,
+             qPrintable(QString("завершение позже возможного на %1 мс").arg(lateMs)));
+}
+
+QTEST_GUILESS_MAIN(TimerEngineTest)
+#include "timerenginetest.moc"
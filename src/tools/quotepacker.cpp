@@ -0,0 +1,35 @@
+// Утилита сборки: превращает текстовый файл цитат в бинарный пакет .qpack.
+// Запускается из CMake при сборке: quotepacker <quotes.txt> <quotes.qpack>
+// Строки разбираются по тем же правилам, что и в приложении (см. QuoteStore),
+// а сам пакет пишет QuotePack::write из ядра. Байты строк попадают в пакет
+// как есть, поэтому идентификаторы совпадают с посчитанными по текстовому файлу.
+
+#include "../headers/quotepackwriter.h"
+#include "../headers/quotestore.h"
+#include <QCoreApplication>
+#include <QDebug>
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    const QStringList args = app.arguments();
+    if (args.size() != 3) {
+        qCritical() << "Использование: quotepacker <quotes.txt> <quotes.qpack>";
+        return 2;
+    }
+
+    QuoteStore store;
+    if (!store.loadFile(args.at(1))) {
+        qCritical() << "Не удалось прочитать файл цитат:" << args.at(1);
+        return 1;
+    }
+
+    QString error;
+    if (!QuotePack::write(store, args.at(2), &error)) {
+        qCritical() << "Не удалось записать пакет цитат:" << args.at(2) << error;
+        return 1;
+    }
+
+    qInfo() << "Упаковано цитат:" << store.size() << "->" << args.at(2);
+    return 0;
+}